@@ -69,6 +69,28 @@ parameters:
   dtype: int
   default: 1
   options: [ ${", ".join([str(n) for n in range(1, max_nchan+1)])} ]
+% if sourk == 'source':
+- id: subchan
+  label: 'Number Sub-channels'
+  dtype: int
+  default: 0
+  hide: ${'$'}{ 'none' if subchan else 'part'}
+- id: spectrum_size
+  label: 'Spectrum Size'
+  dtype: int
+  default: 0
+  hide: ${'$'}{ 'none' if spectrum_size else 'part'}
+- id: sweep_hops
+  label: 'Sweep Hops'
+  dtype: int
+  default: 0
+  hide: ${'$'}{ 'none' if sweep_hops else 'part'}
+- id: sweep_bins
+  label: 'Sweep Bins'
+  dtype: int
+  default: 256
+  hide: ${'$'}{ 'none' if sweep_hops else 'all'}
+% endif
 - id: sample_rate
   label: 'Sample Rate (sps)'
   dtype: real
@@ -85,7 +107,20 @@ outputs:
 % endif
 - domain: stream
   dtype: ${'$'}{type.type}
+% if sourk == 'source':
+  multiplicity: ${'$'}{nchan + subchan}
+## the spectrum, or the sweep without one, comes first: hidden ports only trail
+- domain: stream
+  dtype: float
+  vlen: ${'$'}{max(spectrum_size or sweep_hops * sweep_bins, 1)}
+  hide: ${'$'}{ spectrum_size == 0 and sweep_hops == 0 }
+- domain: stream
+  dtype: float
+  vlen: ${'$'}{max(sweep_hops * sweep_bins, 1)}
+  hide: ${'$'}{ spectrum_size == 0 or sweep_hops == 0 }
+% else:
   multiplicity: ${'$'}{nchan}
+% endif
 % if sourk == 'sink':
 
 outputs:
@@ -192,32 +227,62 @@ documentation: |-
   Lines ending with ... mean it's possible to bind devices together by specifying multiple device arguments separated with a space.
 
   % if sourk == 'source':
-    miri=0[,buffers=32] ...
+    miri=0[,buffers=32][,minbuf=3] ...
     rtl=serial_number ...
     rtl=0[,rtl_xtal=28.8e6][,tuner_xtal=28.8e6] ...
-    rtl=1[,buffers=32][,buflen=N*512] ...
-    rtl=2[,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1] ...
+    rtl=1[,buffers=32][,buflen=N*512][,minbuf=3][,latency_stats=1] ...
+    rtl=2[,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1][,decim=N] ...
     rtl_tcp=127.0.0.1:1234[,psize=16384][,direct_samp=0|1|2][,offset_tune=0|1][,bias=0|1] ...
-    file='/path/to/your file',rate=1e6[,freq=100e6][,repeat=true][,throttle=true] ...
+    file='/path/to/your file',rate=1e6[,freq=100e6][,format=cu8|cs8|cs16|cf32][,repeat=true][,throttle=true][,speed=1][,chunk=N] ...
+    file='/path/to/your.sigmf-data'[,repeat=true][,throttle=true][,speed=1][,chunk=N] ...
+    file='/path/to/your file',rate=1e6[,buffers=8][,buflen=4194304][,preload=1] ...
+    file='/path/to/capture_ch%c.cs8',rate=1e6,nchan=4 ... (one file per channel, interleaved without %c)
     netsdr=127.0.0.1[:50000][,nchan=2]
     sdr-ip=127.0.0.1[:50000]
     cloudiq=127.0.0.1[:50000]
     sdr-iq=/dev/ttyUSB0
     airspy=0[,bias=0|1][,linearity][,sensitivity]
+    sdrplay=0[,buffers=64]
+    rtl=0,resample=1 ... (any device: deliver the requested rate from the nearest hardware rate)
+    hackrf=0,channelize=100e3:25e3;-2e6:200e3 ... (any device: sub-channel outputs follow all device channels)
+    rtl=0,squelch=-40[,squelch_guard=0.01] ... (any device: only forward bursts above -40 dBFS, tagged rx_sob/rx_eob)
+    rtl=0,spectrum=1024[,spectrum_rate=10][,spectrum_alpha=0.25] ... (any device: dBFS vector output after the sub-channels)
+    rtl=0,sweep=88e6:108e6:2e6[,sweep_bins=256][,sweep_dwell=0][,sweep_settle=65536] ... (any device: stitched dBFS vector output after the spectra, settling 4096 samples where the device hops itself)
+    rtl_tcp=127.0.0.1:1234,agc=-20[,agc_attack=0.001][,agc_decay=0.1] ... (any device: AGC mode runs a software AGC towards -20 dBFS, tagged rx_agc)
   % endif
   % if sourk == 'sink':
-    file='/path/to/your file',rate=1e6[,freq=100e6][,append=true][,throttle=true] ...
+    file='/path/to/your file',rate=1e6[,freq=100e6][,format=cu8|cs8|cs16|cf32][,clip_stats=1][,append=true][,throttle=true][,buffers=8][,buflen=4194304][,direct=1][,prealloc=bytes][,overflow=block|drop][,write_stats=1][,sigmf=1][,index=1] ...
+    file='/path/to/capture_%t_%f_%n.cs8',rate=1e6[,rotate_size=bytes][,rotate_secs=60][,max_total=bytes] ...
+    file='/path/to/event_%t_%n.cs8',rate=1e6,pretrigger=5[,posttrigger=1][,trigger_tag=trigger] ...
+    file='/path/to/capture_ch%c.cs8',rate=1e6,nchan=4 ... (one file per channel, interleaved without %c)
   % endif
     redpitaya=192.168.1.100[:1001]
     freesrp=0[,fx3='path/to/fx3.img',fpga='path/to/fpga.bin',loopback]
-    hackrf=0[,buffers=32][,bias=0|1][,bias_tx=0|1]
+    hackrf=0[,buffers=32][,minbuf=3][,bias=0|1][,bias_tx=0|1][,decim=N]
+    hackrf=0,lo_offset=250e3 ... (any device but uhd: LO tuned off center, mixed back in software)
+  % if sourk == 'source':
+    rtl=0,iqbal=gr ... (any device: correct the IQ balance with gr-iqbal instead of the built-in corrector)
+  % endif
     bladerf=0[,tamer=internal|external|external_1pps][,smb=25e6][,feature=oversample|default][,sample_format=16bit|16bit_packed|8bit]
     uhd[,serial=...][,lo_offset=0][,mcr=52e6][,nchan=2][,subdev='\\\\'B:0 A:0\\\\''] ...
     xtrx
+    soapy=0[,driver=...][,format=native|CS16|CS8|CF32]
 
   Num Channels:
   Selects the total number of channels in this multi-device configuration. Required when specifying multiple device arguments.
 
+  % if sourk == 'source':
+  Num Sub-channels:
+  The number of channelize= sub-channels over all devices. Their outputs follow the device channels.
+
+  Spectrum Size:
+  The spectrum= size given in the device arguments, 0 if none. Adds a float vector output after the sub-channels.
+
+  Sweep Hops, Sweep Bins:
+  The number of hops of the sweep= plan, (stop - start) / step + 1, or 0 if none, and its sweep_bins=. Adds a float vector output of hops * bins after the spectrum.
+
+  % endif
+
   Sample Rate:
   The sample rate is the number of samples per second output by this block on each channel.
 
@@ -234,7 +299,7 @@ documentation: |-
     Manual: Keep last estimated correction when switched from Automatic to Manual.
     Automatic: Periodicallly find the best solution to compensate for DC offset.
 
-  This functionality is available for USRP devices only.
+  Devices without a hardware correction are corrected in software.
 
   IQ Balance Mode:
   Controls the behavior of software IQ imbalance corrrection.
@@ -242,7 +307,9 @@ documentation: |-
     Manual: Keep last estimated correction when switched from Automatic to Manual.
     Automatic: Periodicallly find the best solution to compensate for image signals.
 
-  This functionality depends on http://cgit.osmocom.org/cgit/gr-iqbal/
+  Devices without a hardware correction are corrected in software, by a built-in
+  corrector or, with the iqbal=gr device argument, by http://cgit.osmocom.org/cgit/gr-iqbal/
+  if gr-osmosdr was built with it.
 
   Gain Mode:
   Chooses between the manual (default) and automatic gain mode where appropriate.
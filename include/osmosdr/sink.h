@@ -371,6 +371,24 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) = 0;
+
+  /*!
+   * Set the time at which subsequent commands (like set_center_freq) take
+   * effect. This allows to retune several channels or devices at once.
+   * Devices with hardware support (USRP, bladeRF) execute the commands at
+   * the given time.
+   * \param time_spec the time at which the commands take effect
+   * \param mboard the motherboard index 0 to M-1
+   * \throw std::runtime_error if the device has no timed commands
+   */
+  virtual void set_command_time(const ::osmosdr::time_spec_t &time_spec,
+                                size_t mboard = 0) = 0;
+
+  /*!
+   * Clear the command time so subsequent commands take effect immediately.
+   * \param mboard the motherboard index 0 to M-1
+   */
+  virtual void clear_command_time(size_t mboard = 0) = 0;
 };
 
 } /* namespace osmosdr */
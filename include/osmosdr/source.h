@@ -68,6 +68,31 @@ public:
    */
   virtual bool seek( long seek_point, int whence, size_t chan = 0 ) = 0;
 
+  /*!
+   * \brief seek file to the sample recorded at \p time
+   *
+   * Uses the time index written by the file sink (index=1) or, lacking
+   * that, the time stamps of the SigMF capture segments.
+   *
+   * \param time	absolute time of the sample to seek to
+   * \param chan	the channel index 0 to N-1
+   * \return true on success
+   */
+  virtual bool seek_time( const ::osmosdr::time_spec_t &time, size_t chan = 0 ) = 0;
+
+  /*!
+   * \brief seek file to the first sample of capture segment \p segment
+   *
+   * Segments are the SigMF captures of the recording, one per retune or
+   * time stamp. Lacking metadata, they are taken from the time index:
+   * every run of entries recorded at one frequency without a gap.
+   *
+   * \param segment	the segment index 0 to N-1
+   * \param chan	the channel index 0 to N-1
+   * \return true on success, false if there is no such segment
+   */
+  virtual bool seek_segment( size_t segment, size_t chan = 0 ) = 0;
+
   /*!
    * Get the possible sample rates for the underlying radio hardware.
    * \return a range of rates in Sps
@@ -292,6 +317,14 @@ public:
   /*!
    * Set the RX frontend IQ balance correction.
    * Use this to adjust the magnitude and phase of I and Q.
+   * Only set this when automatic correction is disabled.
+   *
+   * Devices correcting the balance in hardware take their native
+   * correction value. For the others the balance is corrected in software,
+   * by a built-in corrector or, with the iqbal=gr device argument, by
+   * gr-iqbalance. Both take the relative gain error between I and Q
+   * as the real part, 0 being balanced, and the phase error in radians as
+   * the imaginary part.
    *
    * \param balance the complex correction value
    * \param chan the channel index 0 to N-1
@@ -416,6 +449,28 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) = 0;
+
+  /*!
+   * Set the time at which subsequent commands (like set_center_freq) take
+   * effect. This allows to retune several channels or devices at once.
+   * Devices with hardware support (USRP, bladeRF) execute the commands at
+   * the given time. Other sources emulate it: RTL-SDR, HackRF and MiriSDR
+   * are retuned once they have captured the sample of that time, and the
+   * first sample taken at the new frequency is marked with an rx_freq tag.
+   * For the remaining sources the emulation is approximate: the retune is
+   * applied when the stream reaches that time, so samples still buffered
+   * in the driver follow the rx_freq tag although they were taken before.
+   * \param time_spec the time at which the commands take effect
+   * \param mboard the motherboard index 0 to M-1
+   */
+  virtual void set_command_time(const ::osmosdr::time_spec_t &time_spec,
+                                size_t mboard = 0) = 0;
+
+  /*!
+   * Clear the command time so subsequent commands take effect immediately.
+   * \param mboard the motherboard index 0 to M-1
+   */
+  virtual void clear_command_time(size_t mboard = 0) = 0;
 };
 
 } /* namespace osmosdr */
@@ -0,0 +1,140 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_AGC_TRACKER_H
+#define INCLUDED_AGC_TRACKER_H
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+/* the applied gain moves in steps of at least this */
+#define AGC_STEP_DB 0.1
+#define AGC_MIN_DB -40.0
+#define AGC_MAX_DB 60.0
+
+/*
+ * Software AGC for sources whose device has none or only a crude one.
+ *
+ * The gain follows the mean power of the stream once per block, from the
+ * power sum the owner accumulates while it converts or copies the stream,
+ * so the level lands on the target.  It falls with the attack and rises
+ * with the decay time constant.  The applied gain only moves in steps of
+ * AGC_STEP_DB, it stays constant over most blocks and every change can be
+ * marked with an rx_agc tag holding the new linear factor.  Powers are in
+ * full scale units, measured before the gain is applied.
+ */
+class agc_tracker
+{
+public:
+  agc_tracker() :
+    _enabled( false ),
+    _target( -20 ),
+    _attack( 0.001 ),
+    _decay( 0.1 ),
+    _rate( 1e6 ), /* until the rate is known */
+    _estimate( 0 ),
+    _gain_db( 0 ),
+    _gain( 1 )
+  {
+  }
+
+  /* target level in dBFS, attack and decay time constants in seconds */
+  void configure( double target, double attack, double decay )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _target = target;
+    _attack = attack;
+    _decay = decay;
+  }
+
+  /* disabling returns to unity gain */
+  void set_enabled( bool enabled )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( ! enabled ) {
+      _estimate = _gain_db = 0;
+      _gain = 1;
+    }
+
+    _enabled = enabled;
+  }
+
+  bool enabled()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return _enabled;
+  }
+
+  /* rate of the samples fed to update() */
+  void set_sample_rate( double rate )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( rate > 0 )
+      _rate = rate;
+  }
+
+  /* linear amplitude factor to apply */
+  float gain()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return _gain;
+  }
+
+  /* feed the power sum of n samples taken before the gain */
+  void update( double power, size_t n )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( ! _enabled || 0 == n || power <= 0 )
+      return;
+
+    double wanted = _target - 10 * std::log10( power / n );
+    wanted = std::min( std::max( wanted, AGC_MIN_DB ), AGC_MAX_DB );
+
+    double tau = ( wanted < _estimate ? _attack : _decay ) * _rate;
+    double alpha = tau > 0 ? 1.0 - std::exp( -double(n) / tau ) : 1.0;
+    _estimate += alpha * ( wanted - _estimate );
+
+    if ( std::abs( _estimate - _gain_db ) >= AGC_STEP_DB ) {
+      _gain_db = _estimate;
+      _gain = std::pow( 10.0, _gain_db / 20 );
+    }
+  }
+
+private:
+  std::mutex _mutex;
+  bool _enabled;
+  double _target;
+  double _attack;
+  double _decay;
+  double _rate;
+  double _estimate; /* dB */
+  double _gain_db;
+  float _gain;
+};
+
+#endif /* INCLUDED_AGC_TRACKER_H */
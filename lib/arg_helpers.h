@@ -109,6 +109,61 @@ inline dict_t params_to_dict( const std::string &params )
   return result;
 }
 
+typedef std::pair< double, double > subchannel_t; /* offset, bandwidth */
+
+/* parses sub-channels given as offset:bandwidth[;offset:bandwidth...] */
+inline std::vector< subchannel_t > params_to_subchannels( const std::string &value )
+{
+  std::vector< subchannel_t > result;
+
+  boost::char_separator<char> separator(";");
+  typedef boost::tokenizer< boost::char_separator<char> > tokenizer_t;
+  tokenizer_t tokens(value, separator);
+
+  for (std::string token : tokens)
+  {
+    std::size_t pos = token.find(':');
+    if (pos == std::string::npos)
+      throw std::runtime_error("Sub-channel '" + token + "' must be given as offset:bandwidth.");
+
+    result.push_back( subchannel_t( boost::lexical_cast<double>( token.substr(0, pos) ),
+                                    boost::lexical_cast<double>( token.substr(pos + 1) ) ) );
+  }
+
+  return result;
+}
+
+/* parses a sweep plan given as start:stop:step into the hop frequencies */
+inline std::vector< double > params_to_sweep( const std::string &value )
+{
+  std::vector< double > result;
+
+  boost::char_separator<char> separator(":");
+  typedef boost::tokenizer< boost::char_separator<char> > tokenizer_t;
+  tokenizer_t tokens(value, separator);
+
+  std::vector< double > plan;
+  for (std::string token : tokens)
+    plan.push_back( boost::lexical_cast<double>( token ) );
+
+  if (plan.size() != 3 || plan[2] <= 0 || plan[1] < plan[0])
+    throw std::runtime_error("Sweep '" + value + "' must be given as start:stop:step.");
+
+  for (size_t i = 0; plan[0] + i * plan[2] <= plan[1] + plan[2] * 1e-6; i++)
+    result.push_back( plan[0] + i * plan[2] );
+
+  return result;
+}
+
+/* output bins per sweep hop */
+inline size_t dict_to_sweep_bins( dict_t &dict )
+{
+  if (dict.count("sweep_bins"))
+    return boost::lexical_cast<size_t>( dict["sweep_bins"] );
+
+  return 256;
+}
+
 struct is_nchan_argument
 {
   bool operator ()(const std::string &str)
@@ -117,10 +172,19 @@ struct is_nchan_argument
   }
 };
 
-inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
+/*
+ * With source_outputs, the signature of osmosdr::source: sub-channel outputs
+ * follow the device channels, spectrum and sweep outputs follow the
+ * sub-channels.
+ */
+inline gr::io_signature::sptr args_to_io_signature( const std::string &args,
+                                                    bool source_outputs = false )
 {
   size_t max_nchan = 0;
   size_t dev_nchan = 0;
+  size_t sub_nchan = 0;
+  std::vector< int > spectra;
+  std::vector< int > sweeps;
   std::vector< std::string > arg_list = args_to_vector( args );
 
   for (std::string arg : arg_list)
@@ -151,13 +215,38 @@ inline gr::io_signature::sptr args_to_io_signature( const std::string &args )
     {
       dev_nchan++; // assume one channel
     }
+
+    if (source_outputs && dict.count("channelize"))
+    {
+      sub_nchan += params_to_subchannels( dict["channelize"] ).size();
+    }
+
+    if (source_outputs && dict.count("spectrum")) // vectors of float bins
+    {
+      spectra.push_back( boost::lexical_cast<size_t>( dict["spectrum"] ) * sizeof(float) );
+    }
+
+    if (source_outputs && dict.count("sweep")) // one vector per sweep
+    {
+      sweeps.push_back( params_to_sweep( dict["sweep"] ).size() *
+                        dict_to_sweep_bins( dict ) * sizeof(float) );
+    }
   }
 
   // if at least one nchan was given, perform a sanity check
   if ( max_nchan && dev_nchan && max_nchan != dev_nchan )
     throw std::runtime_error("Wrong device arguments specified. Missing nchan?");
 
-  const size_t nchan = std::max<size_t>(dev_nchan, 1); // assume at least one
+  // assume at least one, the sub-channels follow the device channels
+  const size_t nchan = std::max<size_t>(dev_nchan, 1) + sub_nchan;
+  if ( spectra.size() || sweeps.size() )
+  {
+    std::vector< int > sizes( nchan, sizeof(gr_complex) );
+    sizes.insert( sizes.end(), spectra.begin(), spectra.end() );
+    sizes.insert( sizes.end(), sweeps.begin(), sweeps.end() );
+    return gr::io_signature::makev(sizes.size(), sizes.size(), sizes);
+  }
+
   return gr::io_signature::make(nchan, nchan, sizeof(gr_complex));
 }
 
@@ -0,0 +1,149 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Compares the built-in IQ balance corrector with the gr-iqbalance chain
+ * (iqbal=gr) on a file source: a tone at rate / 8 recorded with a known
+ * gain and phase imbalance is streamed through osmosdr::source with the
+ * correction off and in automatic mode, reporting the throughput and the
+ * image rejection left at the end of the stream.
+ *
+ *   bench_iq_balance [samples]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_sink.h>
+
+#include <osmosdr/source.h>
+
+#define RATE 1e6
+#define TONE ( RATE / 8 )
+#define GAIN_ERROR 0.05   /* Q is 5 % stronger than I */
+#define PHASE_ERROR 0.05  /* rad */
+#define NOISE 0.01        /* rms, 40 dB below the tone */
+#define IRR_LEN 65536     /* samples measured at the end of the stream */
+
+static std::string write_signal( size_t nsamples )
+{
+  char filename[] = "/tmp/bench_iq_balance_XXXXXX";
+  int fd = mkstemp( filename );
+  FILE *fp = fd >= 0 ? fdopen( fd, "wb" ) : NULL;
+
+  if ( !fp ) {
+    std::cerr << "Failed to create a temporary file." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  std::mt19937 rng( 1 );
+  std::normal_distribution< float > noise( 0, NOISE / std::sqrt( 2.0 ) );
+  std::vector< gr_complex > buf( 65536 );
+
+  for (size_t i = 0; i < nsamples; ) {
+    size_t n = std::min( buf.size(), nsamples - i );
+
+    for (size_t k = 0; k < n; k++, i++) {
+      double w = 2 * M_PI * TONE / RATE * i;
+      buf[k] = gr_complex( std::cos( w ) + noise( rng ),
+                           ( 1 + GAIN_ERROR ) * std::sin( w + PHASE_ERROR ) + noise( rng ) );
+    }
+
+    fwrite( buf.data(), sizeof(gr_complex), n, fp );
+  }
+
+  fclose( fp );
+
+  return filename;
+}
+
+/* power of the tone against its image, in dB */
+static double image_rejection( const std::vector< gr_complex > &data )
+{
+  std::complex< double > tone( 0, 0 ), image( 0, 0 );
+  size_t start = data.size() - std::min( data.size(), size_t( IRR_LEN ) );
+
+  for (size_t i = start; i < data.size(); i++) {
+    std::complex< double > x( data[i] );
+    double w = 2 * M_PI * TONE / RATE * i;
+
+    tone += x * std::polar( 1.0, -w );
+    image += x * std::polar( 1.0, w );
+  }
+
+  return 20 * std::log10( std::abs( tone ) / std::abs( image ) );
+}
+
+static void run( const std::string &name, const std::string &filename,
+                 const std::string &args, int mode )
+{
+  gr::top_block_sptr tb = gr::make_top_block( name );
+  osmosdr::source::sptr src =
+      osmosdr::source::make( "file=" + filename + ",rate=1e6,format=cf32,"
+                             "repeat=false,throttle=false,preload=1" + args );
+  gr::blocks::vector_sink_c::sptr sink = gr::blocks::vector_sink_c::make();
+
+  src->set_iq_balance_mode( mode );
+  tb->connect( src, 0, sink, 0 );
+
+  auto begin = std::chrono::steady_clock::now();
+  tb->run();
+  std::chrono::duration< double > elapsed = std::chrono::steady_clock::now() - begin;
+
+  const std::vector< gr_complex > &data = sink->data();
+
+  std::cout << std::left << std::setw( 12 ) << name << std::right << std::fixed
+            << std::setprecision( 1 ) << std::setw( 10 )
+            << data.size() / elapsed.count() / 1e6 << " Msps"
+            << std::setw( 10 ) << image_rejection( data ) << " dB image rejection"
+            << std::endl;
+}
+
+int main( int argc, char **argv )
+{
+  size_t nsamples = argc > 1 ? size_t( std::atof( argv[1] ) ) : size_t( 1 ) << 24;
+
+  std::string filename = write_signal( nsamples );
+
+  std::cout << nsamples << " samples, gain error " << GAIN_ERROR
+            << ", phase error " << PHASE_ERROR << " rad" << std::endl;
+
+  run( "off", filename, "", osmosdr::source::IQBalanceOff );
+  run( "built-in", filename, "", osmosdr::source::IQBalanceAutomatic );
+  run( "gr-iqbal", filename, ",iqbal=gr", osmosdr::source::IQBalanceAutomatic );
+
+  std::remove( filename.c_str() );
+
+  return EXIT_SUCCESS;
+}
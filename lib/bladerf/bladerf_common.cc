@@ -140,7 +140,8 @@ bladerf_common::bladerf_common() :
   _samples_per_buffer(NUM_SAMPLES_PER_BUFFER),
   _num_transfers(NUM_TRANSFERS),
   _stream_timeout(STREAM_TIMEOUT_MS),
-  _format(BLADERF_FORMAT_SC16_Q11)
+  _format(BLADERF_FORMAT_SC16_Q11),
+  _cmd_timestamp(0)
 {
 }
 
@@ -662,6 +663,15 @@ double bladerf_common::set_center_freq(double freq, bladerf_channel ch)
   if (freqint < freq_range(ch).start() || freqint > freq_range(ch).stop()) {
     BLADERF_WARNING(boost::str(boost::format("Frequency %d Hz is outside "
                     "range, ignoring") % freqint));
+  } else if (_cmd_timestamp != 0) {
+    status = bladerf_schedule_retune(_dev.get(), ch, _cmd_timestamp, freqint, NULL);
+    if (status != 0) {
+      BLADERF_THROW_STATUS(status, boost::str(boost::format("Failed to schedule "
+                    "retune to %d Hz") % freqint));
+    }
+
+    /* the frequency becomes effective later, report what was requested */
+    return static_cast<double>(freqint);
   } else {
     status = bladerf_set_frequency(_dev.get(), ch, freqint);
     if (status != 0) {
@@ -1123,6 +1133,40 @@ double bladerf_common::get_smb_frequency()
   return static_cast<double>(actual_frequency);
 }
 
+void bladerf_common::set_command_time(osmosdr::time_spec_t const &time_spec,
+                                      bladerf_direction dir)
+{
+  int status;
+  uint64_t now;
+
+  /* The timestamp counter runs at the sample rate, relate it to the host
+   * clock which provides the time base for this device */
+  status = bladerf_get_timestamp(_dev.get(), dir, &now);
+  if (status != 0) {
+    BLADERF_THROW_STATUS(status, "Failed to get timestamp");
+  }
+
+  double rate = get_sample_rate((dir == BLADERF_RX) ? BLADERF_CHANNEL_RX(0)
+                                                    : BLADERF_CHANNEL_TX(0));
+  double delta = (time_spec - osmosdr::time_spec_t::get_system_time()).get_real_secs();
+
+  if (delta <= 0) {
+    BLADERF_WARNING("Command time is in the past, retuning immediately");
+    _cmd_timestamp = 0;
+    return;
+  }
+
+  _cmd_timestamp = now + static_cast<uint64_t>(delta * rate + 0.5);
+
+  BLADERF_DEBUG("scheduling retunes at timestamp " << _cmd_timestamp
+                << " (now " << now << ")");
+}
+
+void bladerf_common::clear_command_time()
+{
+  _cmd_timestamp = 0;
+}
+
 /******************************************************************************
  * Private methods
  ******************************************************************************/
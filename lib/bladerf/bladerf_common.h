@@ -31,6 +31,7 @@
 #include <libbladeRF.h>
 
 #include "osmosdr/ranges.h"
+#include "osmosdr/time_spec.h"
 #include "arg_helpers.h"
 
 #include "bladerf_compat.h"
@@ -244,6 +245,12 @@ protected:
   /* Get the current SMB frequency */
   double get_smb_frequency();
 
+  /* Schedule subsequent retunes in direction dir at the given time */
+  void set_command_time(osmosdr::time_spec_t const &time_spec,
+                        bladerf_direction dir);
+  /* Retune immediately again */
+  void clear_command_time();
+
   /*****************************************************************************
    * Protected members
    ****************************************************************************/
@@ -262,6 +269,8 @@ protected:
   bladerf_channel_map _chanmap; /**< map of antennas to channels */
   bladerf_channel_enable_map _enables;  /**< enabled channels */
 
+  uint64_t _cmd_timestamp;      /**< scheduled retune timestamp, 0 = now */
+
   /*****************************************************************************
    * Protected constants
    ****************************************************************************/
@@ -117,6 +117,9 @@ public:
   void set_clock_source(const std::string &source, size_t mboard = 0);
   std::string get_clock_source(size_t mboard);
 
+  bool set_command_time(const osmosdr::time_spec_t &time_spec, size_t mboard = 0);
+  void clear_command_time(size_t mboard = 0);
+
   void set_biastee_mode(const std::string &mode);
 
 private:
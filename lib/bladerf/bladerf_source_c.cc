@@ -569,6 +569,18 @@ std::string bladerf_source_c::get_clock_source(size_t mboard)
   return bladerf_common::get_clock_source(mboard);
 }
 
+bool bladerf_source_c::set_command_time(const osmosdr::time_spec_t &time_spec,
+                                        size_t mboard)
+{
+  bladerf_common::set_command_time(time_spec, BLADERF_RX);
+  return true;
+}
+
+void bladerf_source_c::clear_command_time(size_t mboard)
+{
+  bladerf_common::clear_command_time();
+}
+
 void bladerf_source_c::set_biastee_mode(const std::string &mode)
 {
   int status;
@@ -106,9 +106,11 @@ public:
   std::string set_antenna(const std::string &antenna, size_t chan = 0);
   std::string get_antenna(size_t chan = 0);
 
+  bool has_dc_offset_correction(size_t chan = 0) { return true; }
   void set_dc_offset_mode(int mode, size_t chan = 0);
   void set_dc_offset(const std::complex<double> &offset, size_t chan = 0);
 
+  bool has_iq_balance_correction(size_t chan = 0) { return true; }
   void set_iq_balance_mode(int mode, size_t chan = 0);
   void set_iq_balance(const std::complex<double> &balance, size_t chan = 0);
 
@@ -120,6 +122,10 @@ public:
   void set_clock_source(const std::string &source, size_t mboard = 0);
   std::string get_clock_source(size_t mboard);
 
+  bool has_timed_commands(void) { return true; }
+  bool set_command_time(const osmosdr::time_spec_t &time_spec, size_t mboard = 0);
+  void clear_command_time(size_t mboard = 0);
+
   void set_biastee_mode(const std::string &mode);
 
   void set_loopback_mode(const std::string &loopback);
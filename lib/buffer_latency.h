@@ -0,0 +1,126 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef OSMOSDR_BUFFER_LATENCY_H
+#define OSMOSDR_BUFFER_LATENCY_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/*
+ * Distribution of the time a sample buffer stays queued between the
+ * driver callback and the work() call that starts reading it.  Samples
+ * are collected in power-of-two microsecond buckets, so the reported
+ * percentiles are upper bounds.
+ *
+ * stamp() is called from the driver callback, consumed() from work()
+ * when it starts on a buffer and summary() or reset() from the control
+ * thread, so all of them take the lock of the statistics.
+ */
+class buffer_latency
+{
+public:
+  typedef std::chrono::steady_clock clock;
+
+  buffer_latency() : _count(0), _max(0), _hist(32, 0) {}
+
+  void resize( size_t nslots ) { _stamps.resize( nslots ); }
+
+  void stamp( size_t slot )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _stamps[slot] = clock::now();
+  }
+
+  void consumed( size_t slot )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    clock::now() - _stamps[slot] ).count();
+
+    size_t bucket = 0;
+    while ( (uint64_t(1) << bucket) <= us && bucket < _hist.size() - 1 )
+      bucket++;
+
+    _hist[bucket]++;
+    _count++;
+    if ( us > _max )
+      _max = us;
+  }
+
+  void reset()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _count = _max = 0;
+    std::fill( _hist.begin(), _hist.end(), 0 );
+  }
+
+  /* upper bound of the bucket holding the given fraction of all buffers */
+  uint64_t percentile( double p ) const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return bucket_bound( p );
+  }
+
+  std::string summary() const
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    std::ostringstream ss;
+
+    ss << _count << " buffers, p50 <" << bucket_bound( 0.5 )
+       << "us, p90 <" << bucket_bound( 0.9 )
+       << "us, p99 <" << bucket_bound( 0.99 )
+       << "us, max " << _max << "us";
+
+    return ss.str();
+  }
+
+private:
+  uint64_t bucket_bound( double p ) const
+  {
+    uint64_t target = uint64_t( p * _count ), seen = 0;
+
+    for (size_t i = 0; i < _hist.size(); i++) {
+      seen += _hist[i];
+      if ( seen > target )
+        return uint64_t(1) << i;
+    }
+    return _max;
+  }
+
+  mutable std::mutex _mutex;
+  std::vector< clock::time_point > _stamps;
+  uint64_t _count;
+  uint64_t _max;
+  std::vector< uint64_t > _hist;
+};
+
+#endif /* OSMOSDR_BUFFER_LATENCY_H */
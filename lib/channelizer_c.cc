@@ -0,0 +1,340 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/filter/firdes.h>
+
+#include "channelizer_c.h"
+
+#define CHANNELIZER_MAX_BINS 4096
+#define CHANNELIZER_ATTENUATION 70
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RATE_KEY = pmt::string_to_symbol("rx_rate");
+
+channelizer_c_sptr make_channelizer_c( const std::vector< subchannel_t > &subchannels,
+                                       double rate, double center_freq )
+{
+  return gnuradio::get_initial_sptr( new channelizer_c( subchannels, rate, center_freq ) );
+}
+
+channelizer_c::channelizer_c( const std::vector< subchannel_t > &subchannels,
+                              double rate, double center_freq )
+  : gr::block( "channelizer_c",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( subchannels.size(), subchannels.size(),
+                                       sizeof(gr_complex) ) ),
+    _subchannels( subchannels ),
+    _rate( rate ),
+    _center_freq( center_freq ),
+    _updated( false ),
+    _bins( 0 ),
+    _max_bins( CHANNELIZER_MAX_BINS ),
+    _taps_per_bin( 0 ),
+    _odd( false ),
+    _bin( subchannels.size(), 0 ),
+    _rotators( subchannels.size() ),
+    _tag_freq( subchannels.size(), true ),
+    _tag_rate( true )
+{
+  _id = pmt::string_to_symbol( alias() );
+  set_tag_propagation_policy( TPP_DONT );
+
+  update_bins();
+}
+
+/* must be called with _mutex held */
+void channelizer_c::update_bins( void )
+{
+  double widest = 0;
+
+  for (const subchannel_t &subchannel : _subchannels)
+    widest = std::max( widest, subchannel.second );
+
+  /* bins of rate / M carry sub-channels up to rate / 2M wide, see below */
+  size_t bins = 2;
+  while ( bins < _max_bins && _rate / ( bins * 2 ) >= 2 * widest )
+    bins *= 2;
+
+  if ( bins != _bins ) {
+    /*
+     * The prototype passes 0.75 and stops 1.25 bin widths from the bin
+     * center. At the oversampled output rate of 2 bins, the stopband
+     * aliases onto 0.75 at worst, so everything within 0.25 of the
+     * nearest bin center, or half a bin wide, stays clean.
+     */
+    std::vector<float> proto =
+        gr::filter::firdes::low_pass_2( 1.0, bins, 1.0, 0.5, CHANNELIZER_ATTENUATION,
+                                        gr::fft::window::WIN_BLACKMAN_hARRIS );
+
+    _bins = bins;
+    _taps_per_bin = ( proto.size() + bins - 1 ) / bins;
+    _taps.assign( 2 * _bins * _taps_per_bin, 0.0f );
+
+    for (size_t p = 0; p < _taps_per_bin; p++) {
+      for (size_t r = 0; r < _bins; r++) {
+        size_t index = p * _bins + _bins - 1 - r;
+
+        if ( index < proto.size() )
+          _taps[ ( p * _bins + r ) * 2 ] = _taps[ ( p * _bins + r ) * 2 + 1 ] = proto[index];
+      }
+    }
+
+    _acc.resize( 2 * _bins );
+    _fft.reset( new gr::fft::fft_complex_rev( _bins ) );
+    _odd = false;
+
+    set_history( _bins * _taps_per_bin );
+    set_relative_rate( 2.0 / _bins );
+
+    _updated = true;
+    _tag_rate = true;
+  }
+
+  for (size_t i = 0; i < _subchannels.size(); i++)
+    update_subchannel( i );
+}
+
+/* must be called with _mutex held */
+void channelizer_c::update_subchannel( size_t subchan )
+{
+  double spacing = _rate / _bins;
+  double offset = std::max( -_rate / 2, std::min( _subchannels[subchan].first, _rate / 2 ) );
+
+  if ( spacing > 0 ) {
+    long bin = std::lround( offset / spacing );
+    double residual = offset - bin * spacing;
+
+    _bin[subchan] = size_t( ( bin % long(_bins) + long(_bins) ) % long(_bins) );
+    _rotators[subchan].set_phase_incr(
+        std::polar( 1.0f, float( -2 * M_PI * residual / ( 2 * spacing ) ) ) );
+  }
+
+  _tag_freq[subchan] = true;
+}
+
+bool channelizer_c::start( void )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  /*
+   * The input buffer was sized for the history of the current bins,
+   * more bins later on would need more than it holds.
+   */
+  _max_bins = _bins;
+
+  return true;
+}
+
+void channelizer_c::set_sample_rate( double rate )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( rate != _rate ) {
+    _rate = rate;
+    _bins = 0; /* redesign for the new rate */
+    update_bins();
+  }
+}
+
+double channelizer_c::get_sample_rate( void )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return 2 * _rate / _bins;
+}
+
+double channelizer_c::get_center_freq( void )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return _center_freq;
+}
+
+double channelizer_c::set_offset( double offset, size_t subchan )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( subchan >= _subchannels.size() )
+    return 0;
+
+  _subchannels[subchan].first = offset;
+  update_subchannel( subchan );
+
+  return offset;
+}
+
+double channelizer_c::get_offset( size_t subchan )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return subchan < _subchannels.size() ? _subchannels[subchan].first : 0;
+}
+
+double channelizer_c::set_bandwidth( double bandwidth, size_t subchan )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( subchan >= _subchannels.size() )
+    return 0;
+
+  /* 0 keeps the current bandwidth, like automatic selection on devices */
+  if ( bandwidth > 0 ) {
+    _subchannels[subchan].second = bandwidth;
+    update_bins();
+  }
+
+  return _subchannels[subchan].second;
+}
+
+double channelizer_c::get_bandwidth( size_t subchan )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return subchan < _subchannels.size() ? _subchannels[subchan].second : 0;
+}
+
+void channelizer_c::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  ninput_items_required[0] = noutput_items * ( _bins / 2 ) + history() - 1;
+}
+
+/* acc[i] += x[i] * taps[i] over n floats */
+static void multiply_accumulate( float *acc, const float *x, const float *taps, size_t n )
+{
+  size_t i = 0;
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  for (; i + 4 <= n; i += 4) {
+    __m128 product = _mm_mul_ps( _mm_loadu_ps( x + i ), _mm_loadu_ps( taps + i ) );
+    _mm_storeu_ps( acc + i, _mm_add_ps( _mm_loadu_ps( acc + i ), product ) );
+  }
+#endif
+
+  for (; i < n; i++)
+    acc[i] += x[i] * taps[i];
+}
+
+int channelizer_c::general_work( int noutput_items,
+                                 gr_vector_int &ninput_items,
+                                 gr_vector_const_void_star &input_items,
+                                 gr_vector_void_star &output_items )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( _updated ) {
+    /* let the scheduler apply the new history first */
+    _updated = false;
+    return 0;
+  }
+
+  const size_t decim = _bins / 2;
+  const gr_complex *in = (const gr_complex *)input_items[0] + history() - 1;
+  int nitems = std::min( noutput_items,
+                         int( ( ninput_items[0] - int( history() ) + 1 ) / int( decim ) ) );
+
+  if ( nitems <= 0 )
+    return 0;
+
+  /* output i is computed from the inputs [i * decim, (i + 1) * decim) */
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, nitems_read(0), nitems_read(0) + nitems * decim, FREQ_KEY );
+  std::sort( tags.begin(), tags.end(), gr::tag_t::offset_compare );
+
+  auto tag = tags.begin();
+  for (; tag != tags.end() && tag->offset - nitems_read(0) < decim; ++tag) {
+    if ( pmt::is_number( tag->value ) ) {
+      _center_freq = pmt::to_double( tag->value );
+      std::fill( _tag_freq.begin(), _tag_freq.end(), true );
+    }
+  }
+
+  for (size_t s = 0; s < _subchannels.size(); s++) {
+    if ( _tag_rate )
+      add_item_tag( s, nitems_written(s), RATE_KEY,
+                    pmt::from_double( 2 * _rate / _bins ), _id );
+
+    if ( _tag_freq[s] )
+      add_item_tag( s, nitems_written(s), FREQ_KEY,
+                    pmt::from_double( _center_freq + _subchannels[s].first ), _id );
+
+    _tag_freq[s] = false;
+  }
+
+  _tag_rate = false;
+
+  for (; tag != tags.end(); ++tag) {
+    if ( !pmt::is_number( tag->value ) )
+      continue;
+
+    _center_freq = pmt::to_double( tag->value );
+
+    for (size_t s = 0; s < _subchannels.size(); s++)
+      add_item_tag( s, nitems_written(s) + ( tag->offset - nitems_read(0) ) / decim,
+                    FREQ_KEY, pmt::from_double( _center_freq + _subchannels[s].first ), _id );
+  }
+
+  for (int i = 0; i < nitems; i++) {
+    const gr_complex *newest = in + i * decim + decim - 1;
+
+    /* polyphase partial sums, the newest sample meets the last tap of each bin */
+    std::fill( _acc.begin(), _acc.end(), 0.0f );
+    for (size_t p = 0; p < _taps_per_bin; p++)
+      multiply_accumulate( _acc.data(),
+                           (const float *)( newest - p * _bins - ( _bins - 1 ) ),
+                           &_taps[ p * _bins * 2 ], _bins * 2 );
+
+    gr_complex *fft_in = _fft->get_inbuf();
+    for (size_t r = 0; r < _bins; r++)
+      fft_in[r] = gr_complex( _acc[ ( _bins - 1 - r ) * 2 ], _acc[ ( _bins - 1 - r ) * 2 + 1 ] );
+
+    _fft->execute();
+
+    /* decimating by M / 2 leaves odd bins with a sign flip on odd outputs */
+    const gr_complex *bins = _fft->get_outbuf();
+    for (size_t s = 0; s < _subchannels.size(); s++) {
+      gr_complex sample = bins[ _bin[s] ];
+
+      if ( _odd && ( _bin[s] & 1 ) )
+        sample = -sample;
+
+      ((gr_complex *)output_items[s])[i] = _rotators[s].rotate( sample );
+    }
+
+    _odd = ! _odd;
+  }
+
+  consume_each( nitems * decim );
+
+  return nitems;
+}
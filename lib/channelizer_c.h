@@ -0,0 +1,128 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_CHANNELIZER_C_H
+#define INCLUDED_CHANNELIZER_C_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/blocks/rotator.h>
+#include <gnuradio/fft/fft.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "arg_helpers.h"
+
+class channelizer_c;
+
+typedef std::shared_ptr< channelizer_c > channelizer_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of channelizer_c.
+ *
+ * \param subchannels offset from the center and bandwidth of each output
+ * \param rate sample rate of the wideband input
+ * \param center_freq center frequency of the wideband input
+ */
+channelizer_c_sptr make_channelizer_c( const std::vector< subchannel_t > &subchannels,
+                                       double rate, double center_freq );
+
+/*!
+ * \brief Extracts narrow sub-channels from one wideband stream.
+ *
+ * A 2x oversampled polyphase filterbank splits the input into M bins of
+ * rate / M, M being the largest power of two keeping every sub-channel
+ * within a single bin. Each output takes the bin nearest to its offset
+ * and mixes the remainder down, so it is centered on the requested
+ * offset and runs at 2 * rate / M. The cost per input sample depends on
+ * the filter length per bin and log M, but not on the number of outputs.
+ *
+ * Outputs carry rx_rate tags whenever M changes and rx_freq tags with
+ * their absolute frequency whenever they are retuned. The center of the
+ * input is taken from the rx_freq tags on it, so retunes of the wideband
+ * stream show up on the outputs where they take effect.
+ *
+ * Once running, M stays at or below its value at start: the input
+ * buffer was sized for that history and can't grow.
+ */
+class channelizer_c : public gr::block
+{
+private:
+  friend channelizer_c_sptr make_channelizer_c( const std::vector< subchannel_t > &subchannels,
+                                                double rate, double center_freq );
+
+  channelizer_c( const std::vector< subchannel_t > &subchannels,
+                 double rate, double center_freq );
+
+public:
+  /* notify about the wideband input, sub-channels keep their offsets */
+  void set_sample_rate( double rate );
+
+  /* rate of all outputs */
+  double get_sample_rate( void );
+  /* of the input, as of the last rx_freq tag consumed */
+  double get_center_freq( void );
+
+  double set_offset( double offset, size_t subchan );
+  double get_offset( size_t subchan );
+  double set_bandwidth( double bandwidth, size_t subchan );
+  double get_bandwidth( size_t subchan );
+
+  bool start( void );
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  void update_bins( void );
+  void update_subchannel( size_t subchan );
+
+  pmt::pmt_t _id;
+
+  std::vector< subchannel_t > _subchannels;
+  double _rate;
+  double _center_freq;
+
+  std::mutex _mutex;
+  bool _updated;
+
+  /* filterbank */
+  size_t _bins;
+  size_t _max_bins; /* the history must fit the buffer allocated at start */
+  size_t _taps_per_bin;
+  std::vector< float > _taps; /* reversed per bin, each tap twice for I/Q */
+  std::vector< float > _acc;
+  std::unique_ptr< gr::fft::fft_complex_rev > _fft;
+  bool _odd;
+
+  /* per output */
+  std::vector< size_t > _bin;
+  std::vector< gr::blocks::rotator > _rotators;
+  std::vector< bool > _tag_freq;
+  bool _tag_rate;
+};
+
+#endif /* INCLUDED_CHANNELIZER_C_H */
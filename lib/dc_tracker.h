@@ -0,0 +1,127 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_DC_TRACKER_H
+#define INCLUDED_DC_TRACKER_H
+
+#include <osmosdr/source.h>
+
+#include <cmath>
+#include <complex>
+#include <mutex>
+
+/*
+ * DC offset estimate for sources whose device cannot correct it.
+ *
+ * The estimate follows the mean of the stream through a single pole low
+ * pass that is updated once per block from the sum of its samples, so the
+ * owner only has to accumulate while it converts or copies the stream and
+ * subtract offset() on the way out.  Offsets are in whatever units the
+ * owner feeds to update().
+ */
+class dc_tracker
+{
+public:
+  dc_tracker() :
+    _mode( osmosdr::source::DCOffsetOff ),
+    _tau( 1e5 ), /* until the rate is known */
+    _primed( false )
+  {
+  }
+
+  /* Off forgets the estimate, Manual holds it, Automatic tracks it */
+  void set_mode( int mode )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::DCOffsetOff == mode ) {
+      _offset = 0;
+      _primed = false;
+    }
+
+    _mode = mode;
+  }
+
+  void set_offset( const std::complex<double> &offset )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _offset = offset;
+    _primed = true;
+  }
+
+  /* rate of the samples fed to update(), the time constant is 100 ms */
+  void set_sample_rate( double rate )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( rate > 0 )
+      _tau = rate * 0.1;
+  }
+
+  bool enabled()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return osmosdr::source::DCOffsetOff != _mode;
+  }
+
+  bool tracking()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return osmosdr::source::DCOffsetAutomatic == _mode;
+  }
+
+  std::complex<double> offset()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return _offset;
+  }
+
+  /* feed the sum of n samples, the first block primes the estimate */
+  void update( const std::complex<double> &sum, size_t n )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::DCOffsetAutomatic != _mode || 0 == n )
+      return;
+
+    std::complex<double> mean = sum / double(n);
+
+    if ( ! _primed ) {
+      _offset = mean;
+      _primed = true;
+    } else {
+      _offset += ( 1.0 - std::exp( -double(n) / _tau ) ) * ( mean - _offset );
+    }
+  }
+
+private:
+  std::mutex _mutex;
+  int _mode;
+  double _tau;
+  bool _primed;
+  std::complex<double> _offset;
+};
+
+#endif /* INCLUDED_DC_TRACKER_H */
@@ -0,0 +1,646 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <cstring>
+#include <cerrno>
+#include <cstdio>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include <boost/format.hpp>
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "file_reader_c.h"
+
+/* bytes kept in MADV_WILLNEED state ahead of the read position */
+#define READAHEAD_BYTES (16 * 1024 * 1024)
+
+/* interleaved files are converted and split up in chunks of this many frames */
+#define DEINTERLEAVE_FRAMES 8192
+
+/* pacing restarts from the current time if it falls further behind than this */
+#define PACE_MAX_LATE 0.1
+
+/* default chunk size, in chunks per second of samples */
+#define PACE_CHUNKS_PER_SEC 1000
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RATE_KEY = pmt::string_to_symbol("rx_rate");
+static const pmt::pmt_t TIME_KEY = pmt::string_to_symbol("rx_time");
+
+#if defined(_WIN32) || defined(__APPLE__)
+static double monotonic_now()
+{
+  std::chrono::duration<double> now = std::chrono::steady_clock::now().time_since_epoch();
+  return now.count();
+}
+
+static void sleep_until_monotonic( double deadline )
+{
+  std::chrono::duration<double> until( deadline );
+  std::this_thread::sleep_until( std::chrono::steady_clock::time_point(
+    std::chrono::duration_cast< std::chrono::steady_clock::duration >( until ) ) );
+}
+#else
+static double monotonic_now()
+{
+  struct timespec ts;
+  clock_gettime( CLOCK_MONOTONIC, &ts );
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void sleep_until_monotonic( double deadline )
+{
+  struct timespec ts;
+  ts.tv_sec = time_t( deadline );
+  ts.tv_nsec = long( ( deadline - ts.tv_sec ) * 1e9 );
+
+  while ( EINTR == clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL ) )
+    ;
+}
+#endif
+
+file_reader_c_sptr make_file_reader_c( const std::vector< std::string > &filenames,
+                                       iq_format_t format,
+                                       size_t nchan,
+                                       bool repeat )
+{
+  return gnuradio::get_initial_sptr( new file_reader_c( filenames, format, nchan, repeat ) );
+}
+
+file_reader_c::file_reader_c( const std::vector< std::string > &filenames,
+                              iq_format_t format,
+                              size_t nchan,
+                              bool repeat ) :
+  gr::sync_block("file_reader_c",
+                 gr::io_signature::make(0, 0, 0),
+                 gr::io_signature::make(nchan, nchan, sizeof (gr_complex))),
+  _format(format),
+  _item_size(iq_format_size(format)),
+  _nchan(nchan),
+  _file_chans(0),
+  _frame_size(0),
+  _repeat(repeat),
+  _nitems(0),
+  _pos(0),
+  _frames(NULL),
+  _rate(0),
+  _retag(true),
+  _pace_rate(0),
+  _pace_chunk(0),
+  _pace_started(false),
+  _pace_t0(0),
+  _pace_wall0(0),
+  _pace_items(0),
+  _time_tag(false),
+  _prefetching(false),
+  _ra_num(0),
+  _ra_frames(0),
+  _ra_base(0),
+  _ra_read(0),
+  _ra_ready(0),
+  _ra_gen(0),
+  _ra_underruns(0),
+  _ra_fill_min(1)
+{
+  if ( filenames.empty() || nchan % filenames.size() )
+    throw std::runtime_error( "Channels must be spread evenly across the files." );
+
+  _file_chans = nchan / filenames.size();
+  _frame_size = _file_chans * _item_size;
+
+  _files.resize( filenames.size() );
+
+  try {
+    for (size_t i = 0; i < filenames.size(); i++) {
+      map_file( _files[i], filenames[i] );
+
+      uint64_t nitems = _files[i].size / _frame_size;
+
+      if ( i && nitems != _nitems )
+        std::cerr << "WARNING: " << filenames[i] << " holds " << nitems
+                  << " samples, " << filenames[0] << " " << _nitems
+                  << ". Using the shorter length." << std::endl;
+
+      _nitems = i ? std::min( _nitems, nitems ) : nitems;
+    }
+
+    if ( 0 == _nitems )
+      throw std::runtime_error( "File " + filenames[0] + " holds no samples." );
+  } catch ( ... ) {
+    unmap_files();
+    throw;
+  }
+
+  if ( _file_chans > 1 ) {
+    _frames = (gr_complex *)volk_malloc( DEINTERLEAVE_FRAMES * _file_chans * sizeof(gr_complex),
+                                         volk_get_alignment() );
+    if ( !_frames )
+      throw std::runtime_error( "Failed to allocate file reader buffers." );
+  }
+
+  _chans.resize( _file_chans );
+
+  for (size_t i = 0; i < _files.size(); i++)
+    advise( _files[i], 0 );
+}
+
+file_reader_c::~file_reader_c()
+{
+  stop();
+  unmap_files();
+
+  if ( _frames )
+    volk_free( _frames );
+}
+
+void file_reader_c::map_file( mapping_t &file, const std::string &filename )
+{
+  file.data = NULL;
+  file.size = 0;
+  file.advised_begin = 0;
+  file.advised_end = 0;
+
+#ifndef _WIN32
+  int fd = open( filename.c_str(), O_RDONLY );
+  if ( fd < 0 )
+    throw std::runtime_error( "Failed to open " + filename + ": " + strerror(errno) );
+
+  struct stat st;
+  if ( fstat( fd, &st ) < 0 ) {
+    close( fd );
+    throw std::runtime_error( "Failed to stat " + filename + ": " + strerror(errno) );
+  }
+
+  if ( uint64_t(st.st_size) < _frame_size ) {
+    close( fd );
+    throw std::runtime_error( "File " + filename + " holds no samples." );
+  }
+
+  void *map = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+  close( fd );
+
+  if ( MAP_FAILED == map )
+    throw std::runtime_error( "Failed to map " + filename + ": " + strerror(errno) );
+
+  madvise( map, st.st_size, MADV_SEQUENTIAL );
+  file.data = (const unsigned char *)map;
+  file.size = st.st_size;
+#else
+  std::ifstream stream( filename.c_str(), std::ios::binary );
+  if ( !stream )
+    throw std::runtime_error( "Failed to open " + filename );
+
+  file.buf.assign( std::istreambuf_iterator<char>( stream ),
+                   std::istreambuf_iterator<char>() );
+
+  if ( file.buf.size() < _frame_size )
+    throw std::runtime_error( "File " + filename + " holds no samples." );
+
+  file.data = file.buf.data();
+  file.size = file.buf.size();
+#endif
+}
+
+void file_reader_c::unmap_files()
+{
+#ifndef _WIN32
+  for (size_t i = 0; i < _files.size(); i++)
+    if ( _files[i].data && _files[i].buf.empty() )
+      munmap( (void *)_files[i].data, _files[i].size );
+#endif
+}
+
+void file_reader_c::preload()
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  for (size_t i = 0; i < _files.size(); i++) {
+    mapping_t &file = _files[i];
+
+    if ( file.buf.size() )
+      continue;
+
+    file.buf.assign( file.data, file.data + file.size );
+#ifndef _WIN32
+    munmap( (void *)file.data, file.size );
+#endif
+    file.data = file.buf.data();
+  }
+}
+
+/* faults in the pages of data[begin, end) */
+static void fault_in( const unsigned char *data, uint64_t begin, uint64_t end )
+{
+#ifndef _WIN32
+  static const uint64_t page = sysconf( _SC_PAGESIZE );
+  volatile unsigned char sink;
+
+  begin -= begin % page;
+
+  /* let the reads for the whole range run in parallel, then wait for them */
+  madvise( (void *)(data + begin), end - begin, MADV_WILLNEED );
+
+  for (uint64_t offset = begin; offset < end; offset += page)
+    sink = data[offset];
+
+  (void)sink;
+#endif
+}
+
+void file_reader_c::advise( mapping_t &file, uint64_t pos )
+{
+#ifndef _WIN32
+  static const uint64_t page = sysconf( _SC_PAGESIZE );
+  uint64_t offset = pos * _frame_size;
+
+  if ( offset >= file.advised_begin &&
+       ( offset + READAHEAD_BYTES / 2 < file.advised_end || file.advised_end == file.size ) )
+    return;
+
+  uint64_t begin = offset - offset % page;
+  uint64_t end = std::min< uint64_t >( begin + READAHEAD_BYTES, file.size );
+
+  madvise( (void *)(file.data + begin), end - begin, MADV_WILLNEED );
+
+  /* fault in the start of the file as well so the wrap doesn't stall */
+  if ( _repeat && end == file.size )
+    madvise( (void *)file.data, std::min< uint64_t >( READAHEAD_BYTES, file.size ),
+             MADV_WILLNEED );
+
+  file.advised_begin = begin;
+  file.advised_end = end;
+#endif
+}
+
+void file_reader_c::set_captures( double rate,
+                                  const std::vector< sigmf_capture_t > &captures )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _rate = rate;
+  _captures = captures;
+  _retag = true;
+}
+
+void file_reader_c::set_pacing( double rate, double speed, size_t chunk )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _pace_rate = rate * speed;
+  _pace_chunk = chunk ? chunk : std::max< size_t >( rate / PACE_CHUNKS_PER_SEC, 1 );
+  _pace_started = false;
+}
+
+void file_reader_c::set_readahead( size_t buf_num, size_t buf_size )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _ra_num = buf_num;
+  _ra_frames = std::max< size_t >( buf_size / _frame_size, 1 );
+}
+
+double file_reader_c::readahead_fill()
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( !_prefetching )
+    return 0;
+
+  uint64_t ahead = _ra_ready > _ra_read ? _ra_ready - _ra_read : 0;
+
+  return std::min( double(ahead) / ( _ra_num * _ra_frames ), 1.0 );
+}
+
+uint64_t file_reader_c::underruns()
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return _ra_underruns;
+}
+
+bool file_reader_c::start()
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _pace_started = false;
+
+  /* nothing to prefetch once the files are in memory */
+  if ( _ra_num && _files[0].buf.empty() && !_prefetching ) {
+    _prefetching = true;
+    _ra_base = _pos;
+    _ra_read = _ra_ready = 0;
+    _ra_gen++;
+    _ra_fill_min = 1;
+
+    _prefetch = gr::thread::thread( _prefetch_wait, this );
+  }
+
+  return true;
+}
+
+bool file_reader_c::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( !_prefetching )
+      return true;
+
+    _prefetching = false;
+  }
+  _prefetch_cond.notify_all();
+
+  if ( _prefetch.joinable() )
+    _prefetch.join();
+
+  if ( _ra_underruns )
+    std::cerr << boost::format("file source: %d readahead underruns, "
+                               "lowest fill level %.0f%%")
+                 % _ra_underruns % (100 * _ra_fill_min)
+              << std::endl;
+
+  return true;
+}
+
+void file_reader_c::_prefetch_wait( file_reader_c *obj )
+{
+  obj->prefetch_wait();
+}
+
+void file_reader_c::prefetch_wait()
+{
+  std::unique_lock<std::mutex> lock( _mutex );
+
+  while ( _prefetching )
+  {
+    uint64_t begin = std::max( _ra_ready, _ra_read );
+    uint64_t end = _ra_read + _ra_num * _ra_frames;
+
+    if ( !_repeat )
+      end = std::min( end, _nitems - std::min( _ra_base, _nitems ) );
+
+    if ( begin >= end ) {
+      _prefetch_cond.wait( lock );
+      continue;
+    }
+
+    uint64_t pos = ( _ra_base + begin ) % _nitems;
+    uint64_t count = std::min( std::min< uint64_t >( end - begin, _ra_frames ),
+                               _nitems - pos );
+    uint64_t gen = _ra_gen;
+
+    lock.unlock();
+
+    for (size_t i = 0; i < _files.size(); i++)
+      fault_in( _files[i].data, pos * _frame_size, ( pos + count ) * _frame_size );
+
+    lock.lock();
+
+    /* a seek made this chunk useless */
+    if ( gen == _ra_gen )
+      _ra_ready = begin + count;
+  }
+}
+
+/* called with _mutex held after count frames were read */
+void file_reader_c::consumed( uint64_t count )
+{
+  if ( !_prefetching )
+    return;
+
+  if ( _ra_ready < _ra_read + count ) {
+    if ( 0 == _ra_underruns )
+      std::cerr << "WARNING: file source readahead underrun, the storage "
+                << "can't keep up. Consider more or larger buffers." << std::endl;
+    _ra_underruns++;
+  }
+
+  uint64_t ahead = _ra_ready > _ra_read ? _ra_ready - _ra_read : 0;
+  _ra_fill_min = std::min( _ra_fill_min, double(ahead) / ( _ra_num * _ra_frames ) );
+
+  _ra_read += count;
+  _prefetch_cond.notify_all();
+}
+
+/* the channels were recorded together, so they share their tags */
+void file_reader_c::add_tag( uint64_t offset, const pmt::pmt_t &key,
+                             const pmt::pmt_t &value )
+{
+  for (size_t chan = 0; chan < _nchan; chan++)
+    add_item_tag( chan, offset, key, value );
+}
+
+void file_reader_c::tag_capture( uint64_t offset, const sigmf_capture_t &capture )
+{
+  if ( capture.frequency > 0 )
+    add_tag( offset, FREQ_KEY, pmt::from_double( capture.frequency ) );
+
+  if ( _rate > 0 )
+    add_tag( offset, RATE_KEY, pmt::from_double( _rate ) );
+}
+
+/* converts count frames of a file at _pos into the outputs at offset */
+void file_reader_c::read_frames( size_t file, gr_vector_void_star &output_items,
+                                 uint64_t offset, uint64_t count )
+{
+  const unsigned char *in = _files[file].data + _pos * _frame_size;
+
+  advise( _files[file], _pos );
+
+  if ( 1 == _file_chans ) {
+    iq_format_to_complex( (gr_complex *)output_items[file] + offset, in, count, _format );
+    return;
+  }
+
+  for (uint64_t done = 0; done < count; ) {
+    size_t n = std::min< uint64_t >( count - done, DEINTERLEAVE_FRAMES );
+    const gr_complex *frames = (const gr_complex *)( in + done * _frame_size );
+
+    for (size_t c = 0; c < _file_chans; c++)
+      _chans[c] = (gr_complex *)output_items[file * _file_chans + c] + offset + done;
+
+    if ( IQ_FORMAT_CF32 != _format ) {
+      iq_format_to_complex( _frames, in + done * _frame_size, n * _file_chans, _format );
+      frames = _frames;
+    }
+
+    iq_deinterleave( _chans.data(), frames, n, _file_chans );
+
+    done += n;
+  }
+}
+
+/* tags the samples [pos, pos + count) of the file, written at offset */
+void file_reader_c::tag_captures( uint64_t offset, uint64_t pos, uint64_t count )
+{
+  if ( _captures.empty() && _rate <= 0 )
+    return;
+
+  uint64_t first = pos;
+
+  /* after a jump, describe the capture the new position falls into */
+  if ( _retag ) {
+    sigmf_capture_t current;
+    for ( size_t i = 0; i < _captures.size(); i++ )
+      if ( _captures[i].sample_start <= pos )
+        current = _captures[i];
+
+    tag_capture( offset, current );
+    _retag = false;
+    first = pos + 1;
+  }
+
+  for ( size_t i = 0; i < _captures.size(); i++ ) {
+    uint64_t start = _captures[i].sample_start;
+
+    if ( start >= first && start < pos + count )
+      tag_capture( offset + start - pos, _captures[i] );
+  }
+}
+
+bool file_reader_c::seek( long seek_point, int whence )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  int64_t base;
+  switch ( whence ) {
+  case SEEK_SET: base = 0; break;
+  case SEEK_CUR: base = _pos; break;
+  case SEEK_END: base = _nitems; break;
+  default: return false;
+  }
+
+  int64_t pos = base + seek_point;
+  if ( pos < 0 || uint64_t(pos) > _nitems )
+    return false;
+
+  _pos = pos;
+  _retag = true;
+
+  /* restart the readahead from the new position */
+  _ra_base = _pos;
+  _ra_read = _ra_ready = 0;
+  _ra_gen++;
+  _prefetch_cond.notify_all();
+
+  return true;
+}
+
+int file_reader_c::work( int noutput_items,
+                         gr_vector_const_void_star &input_items,
+                         gr_vector_void_star &output_items )
+{
+  int produced = 0;
+  double deadline = 0;
+
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( _pace_rate > 0 ) {
+      double now = monotonic_now();
+
+      if ( !_pace_started ) {
+        _pace_started = true;
+        _pace_t0 = now;
+        _pace_items = 0;
+        _time_tag = true;
+      }
+
+      noutput_items = std::min< uint64_t >( noutput_items, _pace_chunk );
+      deadline = _pace_t0 + ( _pace_items + noutput_items ) / _pace_rate;
+
+      /* like a device after an overflow: continue from now, with a new time stamp */
+      if ( now > deadline + PACE_MAX_LATE ) {
+        _pace_t0 = now - _pace_items / _pace_rate;
+        deadline = now + noutput_items / _pace_rate;
+        _time_tag = true;
+      }
+
+      if ( _time_tag ) {
+        std::chrono::duration<double> wall =
+          std::chrono::system_clock::now().time_since_epoch();
+
+        /* host time corresponding to _pace_t0 */
+        _pace_wall0 = wall.count() - ( now - _pace_t0 );
+      }
+    }
+  }
+
+  if ( deadline > 0 )
+    sleep_until_monotonic( deadline );
+
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( _time_tag && _pace_rate > 0 ) {
+    double secs = _pace_wall0 + _pace_items / _pace_rate;
+    double whole = std::floor( secs );
+
+    add_tag( nitems_written(0), TIME_KEY,
+             pmt::make_tuple( pmt::from_uint64( uint64_t( whole ) ),
+                              pmt::from_double( secs - whole ) ) );
+    _time_tag = false;
+  }
+
+  while ( produced < noutput_items ) {
+    if ( _pos >= _nitems ) {
+      if ( !_repeat )
+        break;
+      _pos = 0;
+      _retag = true;
+    }
+
+    uint64_t n = std::min< uint64_t >( noutput_items - produced, _nitems - _pos );
+
+    tag_captures( nitems_written(0) + produced, _pos, n );
+    consumed( n );
+
+    for (size_t i = 0; i < _files.size(); i++)
+      read_frames( i, output_items, produced, n );
+
+    produced += n;
+    _pos += n;
+  }
+
+  _pace_items += produced;
+
+  if ( 0 == produced )
+    return WORK_DONE;
+
+  return produced;
+}
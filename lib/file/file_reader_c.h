@@ -0,0 +1,181 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef FILE_READER_C_H
+#define FILE_READER_C_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/thread/thread.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+
+#include "iq_format.h"
+#include "sigmf.h"
+
+class file_reader_c;
+
+typedef std::shared_ptr< file_reader_c > file_reader_c_sptr;
+
+/*
+ * Reads nchan channels, interleaved sample by sample in one file or spread
+ * evenly across several files, e.g. one per channel.
+ */
+file_reader_c_sptr make_file_reader_c( const std::vector< std::string > &filenames,
+                                       iq_format_t format,
+                                       size_t nchan,
+                                       bool repeat );
+
+/*
+ * Memory mapped IQ file reader.  Samples are converted from the on-disk
+ * format straight into the output buffers.  With repeat enabled the read
+ * position wraps around inside work(), so there is no gap at the end of
+ * the file.  All channels are read in lock-step from the same position.
+ */
+class file_reader_c : public gr::sync_block
+{
+private:
+  friend file_reader_c_sptr make_file_reader_c( const std::vector< std::string > &filenames,
+                                                iq_format_t format,
+                                                size_t nchan,
+                                                bool repeat );
+
+  file_reader_c( const std::vector< std::string > &filenames, iq_format_t format,
+                 size_t nchan, bool repeat );
+
+public:
+  ~file_reader_c();
+
+  bool seek( long seek_point, int whence );
+
+  uint64_t nitems_in_file() const { return _nitems; }
+
+  /*
+   * rx_freq and rx_rate tags are emitted on every channel at every capture
+   * boundary, at the start of the stream and after every seek or wrap
+   * around.
+   */
+  void set_captures( double rate, const std::vector< sigmf_capture_t > &captures );
+
+  /*
+   * Releases the samples in chunks of the given size, each one when a
+   * device running at rate * speed would have finished receiving it,
+   * against CLOCK_MONOTONIC deadlines.  An rx_time tag with the host time
+   * of the first sample is emitted when pacing (re)starts and whenever
+   * the reader fell too far behind and had to skip ahead in time.  A rate
+   * of 0 disables pacing, a chunk of 0 selects 1 ms worth of samples.
+   */
+  void set_pacing( double rate, double speed, size_t chunk );
+
+  /*
+   * Readahead for slow or network storage, where even the kernel's
+   * readahead leaves work() waiting for page faults.  A separate thread
+   * faults in buf_num chunks of buf_size bytes ahead of the read position,
+   * per file, so the blocking I/O happens there.  work() reports an
+   * underrun whenever it gets ahead of the thread.  0 buffers disables it.
+   */
+  void set_readahead( size_t buf_num, size_t buf_size );
+
+  /* copies the files into memory, e.g. for short loops in regression tests */
+  void preload();
+
+  /* fraction of the readahead window ready ahead of the read position */
+  double readahead_fill();
+  uint64_t underruns();
+
+  bool start();
+  bool stop();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  struct mapping_t
+  {
+    const unsigned char *data;
+    uint64_t size;
+    uint64_t advised_begin;
+    uint64_t advised_end;
+    std::vector< unsigned char > buf; /* holds the data unless mapped */
+  };
+
+  void map_file( mapping_t &file, const std::string &filename );
+  void unmap_files();
+  void advise( mapping_t &file, uint64_t pos );
+  void consumed( uint64_t count );
+
+  static void _prefetch_wait( file_reader_c *obj );
+  void prefetch_wait();
+  void read_frames( size_t file, gr_vector_void_star &output_items,
+                    uint64_t offset, uint64_t count );
+  void add_tag( uint64_t offset, const pmt::pmt_t &key, const pmt::pmt_t &value );
+  void tag_capture( uint64_t offset, const sigmf_capture_t &capture );
+  void tag_captures( uint64_t offset, uint64_t pos, uint64_t count );
+
+  iq_format_t _format;
+  size_t _item_size;
+  size_t _nchan;
+  size_t _file_chans;   /* channels interleaved in each file */
+  size_t _frame_size;   /* bytes per sample time in each file */
+  bool _repeat;
+
+  std::vector< mapping_t > _files;
+  uint64_t _nitems;
+  uint64_t _pos;
+
+  /* conversion buffer for interleaved files */
+  gr_complex *_frames;
+  std::vector< gr_complex * > _chans;
+
+  double _rate;
+  std::vector< sigmf_capture_t > _captures;
+  bool _retag;
+
+  double _pace_rate;      /* samples per second of wall time, 0 if disabled */
+  size_t _pace_chunk;
+  bool _pace_started;
+  double _pace_t0;        /* monotonic time of the first sample */
+  double _pace_wall0;     /* and its host time for rx_time */
+  uint64_t _pace_items;   /* released since then */
+  bool _time_tag;
+
+  std::mutex _mutex;
+
+  /*
+   * Readahead state, protected by _mutex.  Positions count frames read
+   * since the last seek, so they keep increasing across wrap arounds.
+   */
+  gr::thread::thread _prefetch;
+  std::condition_variable _prefetch_cond;
+  bool _prefetching;
+  size_t _ra_num;
+  size_t _ra_frames;      /* per buffer */
+  uint64_t _ra_base;      /* file position the counts start from */
+  uint64_t _ra_read;
+  uint64_t _ra_ready;     /* faulted in up to here */
+  uint64_t _ra_gen;       /* bumped by seek() to discard chunks in flight */
+  uint64_t _ra_underruns;
+  double _ra_fill_min;
+};
+
+#endif // FILE_READER_C_H
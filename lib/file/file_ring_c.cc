@@ -0,0 +1,359 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <ctime>
+
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <gnuradio/io_signature.h>
+
+#include "file_ring_c.h"
+#include "file_writer_c.h"
+#include "sigmf.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+/* extra samples in the ring, giving the writer time to save the pre-trigger part */
+#define RING_MIN_SLACK (1 << 20)
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t TRIGGER_PORT = pmt::string_to_symbol("trigger");
+
+file_ring_c_sptr make_file_ring_c( const std::string &filename,
+                                   const file_ring_config_t &config )
+{
+  return gnuradio::get_initial_sptr( new file_ring_c( filename, config ) );
+}
+
+file_ring_c::file_ring_c( const std::string &filename,
+                          const file_ring_config_t &config ) :
+  gr::sync_block("file_ring_c",
+                 gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                 gr::io_signature::make(0, 0, 0)),
+  _filename(file_name_template(filename)),
+  _config(config),
+  _trigger_key(pmt::string_to_symbol(config.trigger_key)),
+  _item_size(iq_format_size(config.format)),
+  _total(0),
+  _horizon(0),
+  _running(false),
+  _seq(0)
+{
+  if ( 0 == _config.pre_items && 0 == _config.post_items )
+    throw std::runtime_error( "Pre-trigger capture needs a pre or post trigger window." );
+
+  _ring_items = _config.pre_items +
+                std::max< uint64_t >( _config.pre_items / 2, RING_MIN_SLACK );
+
+  /* allocated and faulted in up front, so work() never waits for memory */
+  _ring.resize( _ring_items * _item_size );
+
+  message_port_register_in( TRIGGER_PORT );
+  set_msg_handler( TRIGGER_PORT, [this](pmt::pmt_t msg) { this->trigger(); } );
+}
+
+file_ring_c::~file_ring_c()
+{
+  stop();
+}
+
+bool file_ring_c::start()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( _running )
+      return true;
+
+    _running = true;
+  }
+
+  _thread = gr::thread::thread( _writer_wait, this );
+
+  return true;
+}
+
+bool file_ring_c::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( !_running )
+      return true;
+
+    /* pending captures are saved as far as the samples go */
+    _running = false;
+  }
+  _cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return true;
+}
+
+void file_ring_c::trigger()
+{
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    add_trigger( _total );
+  }
+  _cond.notify_all();
+}
+
+void file_ring_c::set_center_freq( double freq )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _config.center_freq = freq;
+}
+
+void file_ring_c::set_sample_rate( double rate )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _config.sample_rate = rate;
+}
+
+/* called with _mutex held */
+void file_ring_c::add_trigger( uint64_t offset )
+{
+  if ( _events.size() && offset <= _events.back().end ) {
+    _events.back().end = std::max( _events.back().end, offset + _config.post_items );
+    return;
+  }
+
+  uint64_t oldest = _horizon > _ring_items ? _horizon - _ring_items : 0;
+
+  event_t ev;
+  ev.begin = std::max( offset > _config.pre_items ? offset - _config.pre_items : 0, oldest );
+  ev.trigger = offset;
+  ev.end = offset + _config.post_items;
+
+  _events.push_back( ev );
+}
+
+void file_ring_c::_writer_wait( file_ring_c *obj )
+{
+  obj->writer_wait();
+}
+
+/* writes the samples [begin, end) from the ring */
+bool file_ring_c::write_ring( int fd, uint64_t begin, uint64_t end )
+{
+  while ( begin < end ) {
+    uint64_t pos = begin % _ring_items;
+    uint64_t count = std::min( end - begin, _ring_items - pos );
+    const unsigned char *buf = &_ring[pos * _item_size];
+    size_t len = count * _item_size;
+
+    while ( len ) {
+      int ret = write( fd, buf, len );
+      if ( ret < 0 ) {
+        if ( EINTR == errno )
+          continue;
+        return false;
+      }
+
+      buf += ret;
+      len -= ret;
+    }
+
+    begin += count;
+  }
+
+  return true;
+}
+
+void file_ring_c::writer_wait()
+{
+  int fd = -1;
+  uint64_t pos = 0;
+  std::string filename;
+  sigmf_meta_t meta;
+
+  while (true)
+  {
+    event_t ev;
+    uint64_t total;
+    bool done = false;
+
+    {
+      std::unique_lock<std::mutex> lock( _mutex );
+
+      auto ready = [&]() {
+        if ( _events.empty() )
+          return false;
+        const event_t &e = _events.front();
+        return fd < 0 || pos < std::min( _total, e.end ) || pos >= e.end;
+      };
+
+      while ( _running && !ready() )
+        _cond.wait( lock );
+
+      if ( _events.empty() )
+        break;
+
+      ev = _events.front();
+      total = _total;
+
+      /* finished, or no more samples coming */
+      if ( fd >= 0 && ( pos >= ev.end || ( !_running && pos >= total ) ) ) {
+        _events.pop_front();
+        done = true;
+      }
+
+      if ( fd < 0 ) {
+        filename = expand_file_name( _filename, _seq++, _config.center_freq, time(NULL) );
+
+        meta = sigmf_meta_t();
+        meta.format = _config.format;
+        meta.sample_rate = _config.sample_rate;
+        meta.captures.push_back( sigmf_capture_t( 0, _config.center_freq ) );
+
+        sigmf_annotation_t annotation;
+        annotation.sample_start = ev.trigger - ev.begin;
+        annotation.comment = "trigger";
+        meta.annotations.push_back( annotation );
+      }
+    }
+
+    if ( fd < 0 && !done ) {
+      fd = open( filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644 );
+      if ( fd < 0 ) {
+        std::cerr << "Failed to open " << filename << ": " << strerror(errno) << std::endl;
+
+        std::lock_guard<std::mutex> lock( _mutex );
+        _events.pop_front();
+        continue;
+      }
+
+      pos = ev.begin;
+    }
+
+    if ( !done ) {
+      uint64_t end = std::min( ev.end, total );
+
+      bool ok = write_ring( fd, pos, end );
+
+      /* the stream doesn't wait for us, make sure nothing was overwritten meanwhile */
+      uint64_t oldest;
+      {
+        std::lock_guard<std::mutex> lock( _mutex );
+        oldest = _horizon > _ring_items ? _horizon - _ring_items : 0;
+
+        if ( !ok || pos < oldest )
+          _events.pop_front();
+      }
+
+      if ( !ok ) {
+        std::cerr << "Failed to write " << filename << ": " << strerror(errno) << std::endl;
+        done = true;
+      } else if ( pos < oldest ) {
+        std::cerr << "WARNING: " << filename << " fell behind the ring, "
+                  << "the capture is cut short." << std::endl;
+
+        /* drop whatever may have been overwritten */
+#ifdef _WIN32
+        _chsize_s( fd, (pos - ev.begin) * _item_size );
+#else
+        if ( ftruncate( fd, (pos - ev.begin) * _item_size ) < 0 )
+          std::cerr << "Failed to truncate " << filename << std::endl;
+#endif
+        done = true;
+      } else {
+        pos = end;
+      }
+    }
+
+    if ( done && fd >= 0 ) {
+      close( fd );
+      fd = -1;
+
+      if ( _config.sigmf ) {
+        try {
+          sigmf_write( sigmf_meta_filename( filename ), meta );
+        } catch ( const std::exception &e ) {
+          std::cerr << "WARNING: " << e.what() << std::endl;
+        }
+      }
+    }
+  }
+}
+
+int file_ring_c::work( int noutput_items,
+                       gr_vector_const_void_star &input_items,
+                       gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  uint64_t start = nitems_read(0);
+
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, start, start + noutput_items );
+
+  /*
+   * Slots are overwritten while the writer may be reading them, publish
+   * how far this call writes first.  The writer checks its samples against
+   * that horizon after reading them and discards them if they were hit.
+   */
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+    _horizon = start + noutput_items;
+  }
+
+  uint64_t skip = uint64_t(noutput_items) > _ring_items ? noutput_items - _ring_items : 0;
+  for (uint64_t i = skip; i < uint64_t(noutput_items); ) {
+    uint64_t pos = (start + i) % _ring_items;
+    uint64_t count = std::min( noutput_items - i, _ring_items - pos );
+
+    iq_format_from_complex( &_ring[pos * _item_size], in + i, count, _config.format );
+    i += count;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _total = start + noutput_items;
+
+    for ( const gr::tag_t &tag : tags ) {
+      if ( pmt::eqv( tag.key, FREQ_KEY ) )
+        _config.center_freq = pmt::to_double( tag.value );
+      else if ( pmt::eqv( tag.key, _trigger_key ) )
+        add_trigger( tag.offset );
+    }
+  }
+  _cond.notify_all();
+
+  return noutput_items;
+}
@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef FILE_RING_C_H
+#define FILE_RING_C_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/thread/thread.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+
+#include "iq_format.h"
+
+struct file_ring_config_t
+{
+  file_ring_config_t() :
+    format(IQ_FORMAT_CF32),
+    pre_items(0),
+    post_items(0),
+    trigger_key("trigger"),
+    sigmf(false),
+    sample_rate(0),
+    center_freq(0)
+  {}
+
+  iq_format_t format;       /* of the ring as well as the files */
+  uint64_t pre_items;       /* samples kept from before the trigger */
+  uint64_t post_items;      /* samples recorded after it */
+  std::string trigger_key;  /* stream tag that fires the trigger */
+  bool sigmf;
+  double sample_rate;
+  double center_freq;
+};
+
+class file_ring_c;
+
+typedef std::shared_ptr< file_ring_c > file_ring_c_sptr;
+
+file_ring_c_sptr make_file_ring_c( const std::string &filename,
+                                   const file_ring_config_t &config );
+
+/*
+ * Pre-trigger capture.  The most recent samples are kept in a preallocated
+ * ring in the on-disk format.  A trigger, either a stream tag or a message
+ * on the "trigger" port, saves the pre_items samples before it and the
+ * post_items samples after it to a new file named after the template (see
+ * file_name_template()).  Files are written by a separate thread straight
+ * from the ring, the stream is never stalled; if the writer falls behind
+ * by more than the ring's slack the capture is cut short instead.
+ * Triggers within a running capture extend it.
+ */
+class file_ring_c : public gr::sync_block
+{
+private:
+  friend file_ring_c_sptr make_file_ring_c( const std::string &filename,
+                                            const file_ring_config_t &config );
+
+  file_ring_c( const std::string &filename, const file_ring_config_t &config );
+
+public:
+  ~file_ring_c();
+
+  bool start();
+  bool stop();
+
+  /* triggers at the next sample received */
+  void trigger();
+
+  void set_center_freq( double freq );
+  void set_sample_rate( double rate );
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  struct event_t
+  {
+    uint64_t begin;
+    uint64_t trigger;
+    uint64_t end;
+  };
+
+  void add_trigger( uint64_t offset );
+
+  static void _writer_wait( file_ring_c *obj );
+  void writer_wait();
+  bool write_ring( int fd, uint64_t begin, uint64_t end );
+
+  std::string _filename;
+  file_ring_config_t _config;
+  pmt::pmt_t _trigger_key;
+  size_t _item_size;
+
+  std::vector< unsigned char > _ring;
+  uint64_t _ring_items;
+  uint64_t _total;          /* samples received, the ring holds the last ones */
+  uint64_t _horizon;        /* samples work() may have written to the ring */
+
+  gr::thread::thread _thread;
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  bool _running;
+  std::deque< event_t > _events;
+  uint64_t _seq;
+};
+
+#endif // FILE_RING_C_H
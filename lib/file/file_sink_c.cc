@@ -40,14 +40,19 @@ file_sink_c_sptr make_file_sink_c(const std::string &args)
 
 file_sink_c::file_sink_c(const std::string &args) :
   gr::hier_block2("file_sink_c",
-                 gr::io_signature::make(1, 1, sizeof (gr_complex)),
+                 args_to_io_signature(args),
                  gr::io_signature::make(0, 0, 0))
 {
   std::string filename;
+  std::string format;
+  file_writer_config_t config;
+  file_ring_config_t ring_config;
+  double pretrigger = 0, posttrigger = 0;
   bool append = false;
   bool throttle = false;
   _freq = 0;
   _rate = 0;
+  _nchan = std::max(1, args_to_io_signature(args)->max_streams());
 
   dict_t dict = params_to_dict(args);
 
@@ -60,6 +65,61 @@ file_sink_c::file_sink_c(const std::string &args) :
   if (dict.count("rate"))
     _rate = boost::lexical_cast< double >( dict["rate"] );
 
+  if (dict.count("format"))
+    format = dict["format"];
+
+  if (dict.count("clip_stats"))
+    config.count_clipped = boost::lexical_cast< bool >( dict["clip_stats"] );
+
+  if (dict.count("buffers"))
+    config.buf_num = boost::lexical_cast< size_t >( dict["buffers"] );
+
+  if (dict.count("buflen"))
+    config.buf_size = boost::lexical_cast< size_t >( dict["buflen"] );
+
+  if (dict.count("direct"))
+    config.direct = boost::lexical_cast< bool >( dict["direct"] );
+
+  if (dict.count("prealloc"))
+    config.prealloc = boost::lexical_cast< double >( dict["prealloc"] );
+
+  if (dict.count("overflow")) {
+    if ("drop" == dict["overflow"])
+      config.drop = true;
+    else if ("block" != dict["overflow"])
+      throw std::runtime_error("Parameter 'overflow' must be 'block' or 'drop'.");
+  }
+
+  if (dict.count("sigmf"))
+    config.sigmf = boost::lexical_cast< bool >( dict["sigmf"] );
+  else
+    config.sigmf = (filename.size() > 11 &&
+                    filename.substr(filename.size() - 11) == ".sigmf-data");
+
+  if (dict.count("index"))
+    config.index = boost::lexical_cast< bool >( dict["index"] );
+
+  if (dict.count("rotate_size"))
+    config.rotate_bytes = boost::lexical_cast< double >( dict["rotate_size"] );
+
+  if (dict.count("rotate_secs"))
+    config.rotate_secs = boost::lexical_cast< double >( dict["rotate_secs"] );
+
+  if (dict.count("max_total"))
+    config.max_total = boost::lexical_cast< double >( dict["max_total"] );
+
+  if (dict.count("pretrigger"))
+    pretrigger = boost::lexical_cast< double >( dict["pretrigger"] );
+
+  if (dict.count("posttrigger"))
+    posttrigger = boost::lexical_cast< double >( dict["posttrigger"] );
+
+  if (dict.count("trigger_tag"))
+    ring_config.trigger_key = dict["trigger_tag"];
+
+  if (dict.count("write_stats"))
+    config.stats = boost::lexical_cast< bool >( dict["write_stats"] );
+
   if (dict.count("throttle"))
     throttle = ("true" == dict["throttle"] ? true : false);
 
@@ -75,19 +135,65 @@ file_sink_c::file_sink_c(const std::string &args) :
   if (0 == _rate && throttle)
     throw std::runtime_error("Parameter 'rate' is missing in arguments.");
 
-  _file_rate = _rate;
+  if (0 == _rate && config.rotate_secs > 0)
+    throw std::runtime_error("Parameter 'rotate_secs' requires 'rate'.");
 
-  _sink = gr::blocks::file_sink::make( sizeof(gr_complex),
-                                           filename.c_str(),
-                                           append);
+  if (0 == _rate && (pretrigger > 0 || posttrigger > 0))
+    throw std::runtime_error("Parameters 'pretrigger' and 'posttrigger' require 'rate'.");
 
-  _throttle = gr::blocks::throttle::make( sizeof(gr_complex), _file_rate );
+  if (_nchan > 1 && (pretrigger > 0 || posttrigger > 0))
+    throw std::runtime_error("Parameters 'pretrigger' and 'posttrigger' support a single channel only.");
+
+  if (config.max_total && !config.rotate_bytes && config.rotate_secs <= 0)
+    throw std::runtime_error("Parameter 'max_total' requires 'rotate_size' or 'rotate_secs'.");
+
+  _file_rate = _rate;
 
-  if (throttle) {
-    connect( self(), 0, _throttle, 0 );
-    connect( _throttle, 0, _sink, 0 );
+  config.format = format.length() ? iq_format_from_string( format )
+                                  : iq_format_from_filename( filename );
+  config.append = append;
+  config.sample_rate = _rate;
+  config.center_freq = _freq;
+
+  /* the block connected to each input channel, and its port */
+  std::vector< std::pair< gr::basic_block_sptr, int > > sinks;
+
+  if (pretrigger > 0 || posttrigger > 0) {
+    ring_config.format = config.format;
+    ring_config.pre_items = pretrigger * _rate;
+    ring_config.post_items = posttrigger * _rate;
+    ring_config.sigmf = config.sigmf;
+    ring_config.sample_rate = _rate;
+    ring_config.center_freq = _freq;
+
+    _ring = make_file_ring_c( filename, ring_config );
+    sinks.push_back( std::make_pair( _ring, 0 ) );
+
+    message_port_register_hier_in( pmt::mp("trigger") );
+    msg_connect( self(), "trigger", _ring, "trigger" );
+  } else if (std::string::npos != filename.find("%c")) {
+    /* one file per channel */
+    for (size_t chan = 0; chan < _nchan; chan++) {
+      _sinks.push_back( make_file_writer_c( channel_file_name( filename, chan ), config ) );
+      sinks.push_back( std::make_pair( _sinks.back(), 0 ) );
+    }
   } else {
-    connect( self(), 0, _sink, 0 );
+    config.nchan = _nchan;
+    _sinks.push_back( make_file_writer_c( filename, config ) );
+
+    for (size_t chan = 0; chan < _nchan; chan++)
+      sinks.push_back( std::make_pair( _sinks.back(), chan ) );
+  }
+
+  for (size_t chan = 0; chan < _nchan; chan++) {
+    _throttles.push_back( gr::blocks::throttle::make( sizeof(gr_complex), _file_rate ) );
+
+    if (throttle) {
+      connect( self(), chan, _throttles[chan], 0 );
+      connect( _throttles[chan], 0, sinks[chan].first, sinks[chan].second );
+    } else {
+      connect( self(), chan, sinks[chan].first, sinks[chan].second );
+    }
   }
 }
 
@@ -107,7 +213,7 @@ std::vector<std::string> file_sink_c::get_devices( bool fake )
   if ( fake )
   {
     std::string args = "file='/path/to/your/file'";
-    args += ",rate=1e6,freq=100e6,throttle=true";
+    args += ",rate=1e6,freq=100e6,format=cf32,sigmf=1,throttle=true";
     args += ",label='Complex Sampled (IQ) File'";
     devices.push_back( args );
   }
@@ -117,7 +223,7 @@ std::vector<std::string> file_sink_c::get_devices( bool fake )
 
 size_t file_sink_c::get_num_channels( void )
 {
-  return 1;
+  return _nchan;
 }
 
 osmosdr::meta_range_t file_sink_c::get_sample_rates( void )
@@ -138,7 +244,12 @@ double file_sink_c::set_sample_rate( double rate )
               << std::endl;
   }
 
-  _throttle->set_sample_rate( rate );
+  for (size_t i = 0; i < _throttles.size(); i++)
+    _throttles[i]->set_sample_rate( rate );
+  for (size_t i = 0; i < _sinks.size(); i++)
+    _sinks[i]->set_sample_rate( rate );
+  if (_ring)
+    _ring->set_sample_rate( rate );
 
   _rate = rate;
 
@@ -157,6 +268,14 @@ osmosdr::freq_range_t file_sink_c::get_freq_range( size_t chan )
 
 double file_sink_c::set_center_freq( double freq, size_t chan )
 {
+  /* starts a new capture segment in the metadata */
+  for (size_t i = 0; i < _sinks.size(); i++)
+    _sinks[i]->set_center_freq( freq );
+  if (_ring)
+    _ring->set_center_freq( freq );
+
+  _freq = freq;
+
   return get_center_freq(chan);
 }
 
@@ -21,10 +21,11 @@
 #define FILE_SINK_C_H
 
 #include <gnuradio/hier_block2.h>
-#include <gnuradio/blocks/file_sink.h>
 #include <gnuradio/blocks/throttle.h>
 
 #include "sink_iface.h"
+#include "file_writer_c.h"
+#include "file_ring_c.h"
 
 class file_sink_c;
 
@@ -72,9 +73,14 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  /* true in pre-trigger mode, the block then has a "trigger" message port */
+  bool has_trigger() const { return (bool)_ring; }
+
 private:
-  gr::blocks::file_sink::sptr _sink;
-  gr::blocks::throttle::sptr _throttle;
+  std::vector< file_writer_c_sptr > _sinks;
+  file_ring_c_sptr _ring;
+  std::vector< gr::blocks::throttle::sptr > _throttles;
+  size_t _nchan;
   double _file_rate;
   double _freq, _rate;
 };
@@ -41,13 +41,20 @@ file_source_c_sptr make_file_source_c(const std::string &args)
 file_source_c::file_source_c(const std::string &args) :
   gr::hier_block2("file_source_c",
                  gr::io_signature::make(0, 0, 0),
-                 gr::io_signature::make(1, 1, sizeof (gr_complex)))
+                 args_to_io_signature(args))
 {
   std::string filename;
+  std::string format;
   bool repeat = true;
-  bool throttle = true;
+  bool preload = false;
+  size_t buf_num = 0;
+  size_t buf_len = 4 * 1024 * 1024;
+  _throttle = true;
+  _speed = 1.0;
+  _chunk = 0;
   _freq = 0;
   _rate = 0;
+  _nchan = std::max(1, args_to_io_signature(args)->max_streams());
 
   dict_t dict = params_to_dict(args);
 
@@ -60,35 +67,104 @@ file_source_c::file_source_c(const std::string &args) :
   if (dict.count("rate"))
     _rate = boost::lexical_cast< double >( dict["rate"] );
 
+  if (dict.count("format"))
+    format = dict["format"];
+
   if (dict.count("repeat"))
     repeat = ("true" == dict["repeat"] ? true : false);
 
   if (dict.count("throttle"))
-    throttle = ("true" == dict["throttle"] ? true : false);
+    _throttle = ("true" == dict["throttle"] ? true : false);
+
+  if (dict.count("speed"))
+    _speed = boost::lexical_cast< double >( dict["speed"] );
+
+  if (dict.count("chunk"))
+    _chunk = boost::lexical_cast< size_t >( dict["chunk"] );
+
+  if (dict.count("buffers"))
+    buf_num = boost::lexical_cast< size_t >( dict["buffers"] );
+
+  if (dict.count("buflen"))
+    buf_len = boost::lexical_cast< size_t >( dict["buflen"] );
+
+  if (dict.count("preload"))
+    preload = boost::lexical_cast< bool >( dict["preload"] );
 
   if (!filename.length())
     throw std::runtime_error("No file name specified.");
 
+  /* accept the metadata file as well as the data file */
+  filename = sigmf_data_filename( filename );
+
+  /* one file per channel if the name has a %c, all channels interleaved otherwise */
+  std::vector< std::string > filenames( 1, filename );
+  if (std::string::npos != filename.find("%c")) {
+    filenames.clear();
+    for (size_t chan = 0; chan < _nchan; chan++)
+      filenames.push_back( channel_file_name( filename, chan ) );
+  }
+
+  /* explicit arguments take precedence over the recorded metadata */
+  sigmf_meta_t meta;
+  bool has_meta = sigmf_read( sigmf_meta_filename( filenames[0] ), meta );
+
+  if (has_meta && meta.num_channels != _nchan / filenames.size())
+    throw std::runtime_error( str( boost::format("%s holds %d channels, set nchan=%d.")
+                                   % filenames[0] % meta.num_channels
+                                   % (meta.num_channels * filenames.size()) ) );
+
+  if (has_meta) {
+    for (const sigmf_capture_t &capture : meta.captures)
+      _segments.push_back( capture.sample_start );
+
+    if (!format.length())
+      format = iq_format_to_string( meta.format );
+
+    if (!dict.count("rate"))
+      _rate = meta.sample_rate;
+
+    if (!dict.count("freq") && meta.captures.size())
+      _freq = meta.captures[0].frequency;
+  }
+
+  if (!has_meta || dict.count("freq"))
+    meta.captures = std::vector< sigmf_capture_t >( 1, sigmf_capture_t( 0, _freq ) );
+
   if (_freq < 0)
     throw std::runtime_error("Parameter 'freq' may not be negative.");
 
-  if (0 == _rate && throttle)
+  if (_speed <= 0)
+    throw std::runtime_error("Parameter 'speed' must be positive.");
+
+  if (0 == _rate && _throttle)
     throw std::runtime_error("Parameter 'rate' is missing in arguments.");
 
   _file_rate = _rate;
 
-  _source = gr::blocks::file_source::make( sizeof(gr_complex),
-                                           filename.c_str(),
-                                           repeat );
+  _source = make_file_reader_c( filenames,
+                                format.length() ? iq_format_from_string( format )
+                                                : iq_format_from_filename( filename ),
+                                _nchan, repeat );
 
-  _throttle = gr::blocks::throttle::make( sizeof(gr_complex), _file_rate );
+  _source->set_captures( _rate, meta.captures );
 
-  if (throttle) {
-    connect( _source, 0, _throttle, 0 );
-    connect( _throttle, 0, self(), 0 );
-  } else {
-    connect( _source, 0, self(), 0 );
-  }
+  if (!_index.load( time_index_filename( filenames[0] ) ) && has_meta)
+    _index.load( meta );
+
+  if (_segments.empty())
+    _segments = _index.segments( _file_rate );
+
+  if (_throttle)
+    _source->set_pacing( _file_rate, _speed, _chunk );
+
+  if (preload)
+    _source->preload();
+  else
+    _source->set_readahead( buf_num, buf_len );
+
+  for (size_t chan = 0; chan < _nchan; chan++)
+    connect( _source, chan, self(), chan );
 }
 
 file_source_c::~file_source_c()
@@ -107,7 +183,7 @@ std::vector<std::string> file_source_c::get_devices( bool fake )
   if ( fake )
   {
     std::string args = "file='/path/to/your/file'";
-    args += ",rate=1e6,freq=100e6,repeat=true,throttle=true";
+    args += ",rate=1e6,freq=100e6,format=cf32,repeat=true,throttle=true,speed=1";
     args += ",label='Complex Sampled (IQ) File'";
     devices.push_back( args );
   }
@@ -117,7 +193,7 @@ std::vector<std::string> file_source_c::get_devices( bool fake )
 
 size_t file_source_c::get_num_channels( void )
 {
-  return 1;
+  return _nchan;
 }
 
 bool file_source_c::seek( long seek_point, int whence , size_t chan )
@@ -125,6 +201,24 @@ bool file_source_c::seek( long seek_point, int whence , size_t chan )
     return _source->seek( seek_point, whence );
 }
 
+bool file_source_c::seek_time( const osmosdr::time_spec_t &time, size_t chan )
+{
+  uint64_t sample;
+
+  if ( !_index.lookup( time.get_full_secs(), time.get_frac_secs(), _file_rate, sample ) )
+    return false;
+
+  return _source->seek( sample, SEEK_SET );
+}
+
+bool file_source_c::seek_segment( size_t segment, size_t chan )
+{
+  if ( segment >= _segments.size() )
+    return false;
+
+  return _source->seek( _segments[segment], SEEK_SET );
+}
+
 osmosdr::meta_range_t file_source_c::get_sample_rates( void )
 {
   osmosdr::meta_range_t range;
@@ -143,7 +237,8 @@ double file_source_c::set_sample_rate( double rate )
               << std::endl;
   }
 
-  _throttle->set_sample_rate( rate );
+  if (_throttle)
+    _source->set_pacing( rate, _speed, _chunk );
 
   _rate = rate;
 
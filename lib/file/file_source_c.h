@@ -21,10 +21,10 @@
 #define FILE_SOURCE_C_H
 
 #include <gnuradio/hier_block2.h>
-#include <gnuradio/blocks/file_source.h>
-#include <gnuradio/blocks/throttle.h>
 
 #include "source_iface.h"
+#include "file_reader_c.h"
+#include "time_index.h"
 
 class file_source_c;
 
@@ -51,6 +51,8 @@ public:
   size_t get_num_channels( void );
 
   bool seek( long seek_point, int whence, size_t chan );
+  bool seek_time( const osmosdr::time_spec_t &time, size_t chan );
+  bool seek_segment( size_t segment, size_t chan );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -75,8 +77,13 @@ public:
   std::string get_antenna( size_t chan = 0 );
 
 private:
-  gr::blocks::file_source::sptr _source;
-  gr::blocks::throttle::sptr _throttle;
+  file_reader_c_sptr _source;
+  time_index _index;
+  std::vector< uint64_t > _segments; /* first sample of each capture segment */
+  bool _throttle;
+  double _speed;
+  size_t _chunk;
+  size_t _nchan;
   double _file_rate;
   double _freq, _rate;
 };
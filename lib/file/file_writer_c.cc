@@ -0,0 +1,1095 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cmath>
+#include <ctime>
+#include <stdexcept>
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <boost/format.hpp>
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "file_writer_c.h"
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RATE_KEY = pmt::string_to_symbol("rx_rate");
+static const pmt::pmt_t TIME_KEY = pmt::string_to_symbol("rx_time");
+
+/* time index entries are added at least this often */
+#define INDEX_INTERVAL_SECS 1
+#define INDEX_INTERVAL_ITEMS (1 << 20) /* if the sample rate is unknown */
+
+/* multiple channels are interleaved and converted in chunks of this many frames */
+#define INTERLEAVE_FRAMES 8192
+
+file_writer_c_sptr make_file_writer_c( const std::string &filename,
+                                       const file_writer_config_t &config )
+{
+  return gnuradio::get_initial_sptr( new file_writer_c( filename, config ) );
+}
+
+file_writer_c::file_writer_c( const std::string &filename,
+                              const file_writer_config_t &config ) :
+  gr::sync_block("file_writer_c",
+                 gr::io_signature::make(config.nchan, config.nchan, sizeof (gr_complex)),
+                 gr::io_signature::make(0, 0, 0)),
+  _filename(filename),
+  _config(config),
+  _item_size(config.nchan * iq_format_size(config.format)),
+  _fd(-1),
+  _direct(config.direct),
+  _frames(NULL),
+  _running(false),
+  _failed(false),
+  _buf_head(0),
+  _buf_used(0),
+  _buf_fill(0),
+  _track_meta(config.sigmf || config.index || rotating()),
+  _items_kept(0),
+  _seg_seq(0),
+  _seg_begin(0),
+  _seg_bytes(0),
+  _seg_bytes_max(0),
+  _closing(false),
+  _seg_done_bytes(0),
+  _clipped(0),
+  _values(0),
+  _buf_used_max(0),
+  _blocked(0),
+  _blocked_secs(0),
+  _written(0),
+  _write_secs(0),
+  _index_pending(true),
+  _index_next(UINT64_MAX),
+  _index_freq(config.center_freq),
+  _time_ref(false),
+  _time_offset(0),
+  _time_secs(0),
+  _time_frac(0),
+  _index_file(NULL),
+  _index_written(false)
+{
+  /* one buffer is always being filled, so at least two are needed */
+  _config.buf_num = std::max< size_t >( _config.buf_num, 2 );
+  _config.buf_size = std::max< size_t >( _config.buf_size, FILE_WRITER_ALIGNMENT );
+  _config.buf_size = (_config.buf_size + FILE_WRITER_ALIGNMENT - 1) /
+                     FILE_WRITER_ALIGNMENT * FILE_WRITER_ALIGNMENT;
+
+#ifndef O_DIRECT
+  if ( _config.direct ) {
+    std::cerr << "WARNING: O_DIRECT is not supported on this platform." << std::endl;
+    _config.direct = _direct = false;
+  }
+#endif
+
+  if ( rotating() ) {
+    _filename = file_name_template( _filename );
+
+    if ( !open_segment() )
+      throw std::runtime_error( "Failed to open " + _seg_filename + ": " + strerror(errno) );
+  } else {
+    _seg_filename = _filename;
+    _fd = open_file( _filename, _config.append );
+
+    if ( _fd < 0 )
+      throw std::runtime_error( "Failed to open " + _filename + ": " + strerror(errno) );
+
+    struct stat st;
+    if ( 0 == fstat( _fd, &st ) )
+      _items_kept = st.st_size / _item_size;
+    _seg_bytes = _items_kept * _item_size;
+
+    if ( _config.index && !open_index( _filename, _config.append ) )
+      throw std::runtime_error( "Failed to open " + time_index_filename( _filename ) +
+                                ": " + strerror(errno) );
+
+    /* keep the segments of the recording we're appending to */
+    if ( _config.sigmf && _config.append &&
+         sigmf_read( sigmf_meta_filename( _filename ), _meta ) &&
+         _meta.format != _config.format )
+      _meta = sigmf_meta_t();
+  }
+
+  _meta.format = _config.format;
+  _meta.num_channels = _config.nchan;
+  if ( _config.sample_rate > 0 )
+    _meta.sample_rate = _config.sample_rate;
+  add_capture( _items_kept, _config.center_freq, "" );
+
+  update_segment_limit();
+
+  for (size_t i = 0; i < _config.buf_num; i++) {
+    unsigned char *buf = (unsigned char *)volk_malloc( _config.buf_size,
+                                                       FILE_WRITER_ALIGNMENT );
+    if ( !buf )
+      throw std::runtime_error( "Failed to allocate file writer buffers." );
+
+    _bufs.push_back( buf );
+  }
+
+  _buf_lens.resize( _config.buf_num );
+
+  if ( _config.nchan > 1 ) {
+    _frames = (gr_complex *)volk_malloc( INTERLEAVE_FRAMES * _config.nchan * sizeof(gr_complex),
+                                         volk_get_alignment() );
+    if ( !_frames )
+      throw std::runtime_error( "Failed to allocate file writer buffers." );
+  }
+
+  _chans.resize( _config.nchan );
+}
+
+file_writer_c::~file_writer_c()
+{
+  stop();
+
+  for (size_t i = 0; i < _bufs.size(); i++)
+    volk_free( _bufs[i] );
+
+  if ( _frames )
+    volk_free( _frames );
+
+  if ( _fd >= 0 )
+    close( _fd );
+
+  if ( _index_file )
+    fclose( _index_file );
+}
+
+int file_writer_c::open_file( const std::string &filename, bool append )
+{
+  int flags = O_WRONLY | O_CREAT | O_BINARY | (append ? O_APPEND : O_TRUNC);
+  int fd = -1;
+
+#ifdef O_DIRECT
+  if ( _direct ) {
+    struct stat st;
+
+    /* appending with O_DIRECT only works at an aligned end of file */
+    if ( append && 0 == stat( filename.c_str(), &st ) &&
+         st.st_size % FILE_WRITER_ALIGNMENT ) {
+      std::cerr << "WARNING: " << filename << " is not a multiple of "
+                << FILE_WRITER_ALIGNMENT << " bytes, not using O_DIRECT." << std::endl;
+      _direct = false;
+    } else {
+      fd = open( filename.c_str(), flags | O_DIRECT, 0644 );
+      if ( fd < 0 ) {
+        std::cerr << "WARNING: O_DIRECT not supported for " << filename
+                  << ": " << strerror(errno) << std::endl;
+        _direct = false;
+      }
+    }
+  }
+#endif
+
+  if ( fd < 0 )
+    fd = open( filename.c_str(), flags, 0644 );
+
+  if ( fd < 0 )
+    return -1;
+
+  if ( _config.prealloc ) {
+#ifdef __linux__
+    struct stat st;
+    off_t offset = ( 0 == fstat( fd, &st ) ) ? st.st_size : 0;
+
+    /* reserve the blocks but keep the file size, so readers see only real data */
+    if ( fallocate( fd, FALLOC_FL_KEEP_SIZE, offset, _config.prealloc ) < 0 )
+      std::cerr << "WARNING: Failed to preallocate " << filename << ": "
+                << strerror(errno) << std::endl;
+#else
+    std::cerr << "WARNING: Preallocation is not supported on this platform." << std::endl;
+#endif
+  }
+
+  return fd;
+}
+
+std::string file_name_template( const std::string &filename )
+{
+  /* make sure every file gets a name of its own */
+  if ( std::string::npos != filename.find("%n") )
+    return filename;
+
+  size_t dot = filename.find_last_of('.');
+  size_t sep = filename.find_last_of("/\\");
+
+  if ( dot == std::string::npos || ( sep != std::string::npos && dot < sep ) )
+    dot = filename.size();
+
+  return filename.substr( 0, dot ) + "_%n" + filename.substr( dot );
+}
+
+std::string expand_file_name( const std::string &tmpl, uint64_t seq,
+                              double freq, time_t now )
+{
+  std::string out;
+
+  for (size_t i = 0; i < tmpl.size(); i++) {
+    if ( '%' != tmpl[i] || i + 1 == tmpl.size() ) {
+      out += tmpl[i];
+      continue;
+    }
+
+    switch ( tmpl[++i] ) {
+    case 'n':
+      out += str( boost::format("%06d") % seq );
+      break;
+    case 't': {
+      struct tm tm;
+      char buf[32];
+#ifdef _WIN32
+      gmtime_s( &tm, &now );
+#else
+      gmtime_r( &now, &tm );
+#endif
+      strftime( buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &tm );
+      out += buf;
+      break;
+    }
+    case 'f':
+      out += str( boost::format("%.0f") % freq );
+      break;
+    case '%':
+      out += '%';
+      break;
+    default:
+      out += '%';
+      out += tmpl[i];
+    }
+  }
+
+  return out;
+}
+
+/* opens the next segment, sets errno on failure */
+bool file_writer_c::open_segment()
+{
+  double freq;
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    freq = _meta.captures.size() ? _meta.captures.back().frequency
+                                 : _config.center_freq;
+  }
+
+  _seg_filename = expand_file_name( _filename, _seg_seq++, freq, time(NULL) );
+  _seg_begin += _seg_bytes / _item_size;
+  _seg_bytes = 0;
+
+  _fd = open_file( _seg_filename, false );
+
+  if ( _fd >= 0 && _config.index && !open_index( _seg_filename, false ) ) {
+    close( _fd );
+    _fd = -1;
+  }
+
+  return _fd >= 0;
+}
+
+/* hands the current segment over to the closer thread */
+void file_writer_c::finish_segment()
+{
+  segment_t seg;
+
+  seg.fd = _fd;
+  seg.filename = _seg_filename;
+  seg.bytes = _seg_bytes;
+
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    seg.meta = segment_meta( _seg_begin, _seg_begin + _seg_bytes / _item_size );
+  }
+
+  _fd = -1;
+
+  if ( _index_file ) {
+    fclose( _index_file );
+    _index_file = NULL;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( _seg_mutex );
+    _seg_queue.push_back( seg );
+  }
+  _seg_cond.notify_all();
+}
+
+static uint64_t lcm( uint64_t a, uint64_t b )
+{
+  uint64_t x = a, y = b;
+
+  while ( y ) {
+    uint64_t t = x % y;
+    x = y;
+    y = t;
+  }
+
+  return a / x * b;
+}
+
+/* called with _buf_mutex held */
+void file_writer_c::update_segment_limit()
+{
+  uint64_t items = UINT64_MAX;
+
+  if ( _config.rotate_bytes )
+    items = _config.rotate_bytes / _item_size;
+
+  if ( _config.rotate_secs > 0 && _meta.sample_rate > 0 )
+    items = std::min< uint64_t >( items, _config.rotate_secs * _meta.sample_rate );
+
+  if ( UINT64_MAX == items ) {
+    _seg_bytes_max = 0;
+    return;
+  }
+
+  /*
+   * O_DIRECT needs every segment but the last to be a whole number of
+   * blocks, and every segment has to hold whole frames
+   */
+  uint64_t unit = _config.direct ? lcm( FILE_WRITER_ALIGNMENT, _item_size ) : _item_size;
+  _seg_bytes_max = std::max( items * _item_size / unit * unit, unit );
+}
+
+/*
+ * Called with _buf_mutex held.  Returns the metadata of the samples
+ * [begin, end) with the segments and annotations rebased to begin.
+ */
+sigmf_meta_t file_writer_c::segment_meta( uint64_t begin, uint64_t end )
+{
+  sigmf_meta_t meta = _meta;
+
+  meta.captures.clear();
+  meta.annotations.clear();
+
+  for ( const sigmf_capture_t &capture : _meta.captures ) {
+    if ( capture.sample_start <= begin ) {
+      meta.captures.clear();
+      meta.captures.push_back( capture );
+
+      /* the time stamp belongs to the first sample of the capture */
+      if ( capture.sample_start < begin )
+        meta.captures.back().datetime.clear();
+    } else if ( capture.sample_start < end ) {
+      meta.captures.push_back( capture );
+    }
+  }
+
+  for ( sigmf_capture_t &capture : meta.captures )
+    capture.sample_start = std::max( capture.sample_start, begin ) - begin;
+
+  for ( const sigmf_annotation_t &annotation : _meta.annotations ) {
+    if ( annotation.sample_start >= begin && annotation.sample_start < end ) {
+      meta.annotations.push_back( annotation );
+      meta.annotations.back().sample_start -= begin;
+    }
+  }
+
+  return meta;
+}
+
+bool file_writer_c::start()
+{
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+
+    if ( _running )
+      return true;
+
+    _buf_head = _buf_used = 0;
+    _buf_fill = 0;
+    _running = true;
+    _index_pending = true;
+  }
+
+  if ( rotating() ) {
+    /* the last segment was handed to the closer when we were stopped */
+    if ( _fd < 0 && !open_segment() ) {
+      std::cerr << "Failed to open " << _seg_filename << ": "
+                << strerror(errno) << std::endl;
+      _failed = true;
+    }
+
+    _closing = true;
+    _closer = gr::thread::thread( _closer_wait, this );
+  }
+
+  _thread = gr::thread::thread( _writer_wait, this );
+
+  /* written up front as well, so a crashed recording keeps its metadata */
+  write_meta();
+
+  return true;
+}
+
+bool file_writer_c::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+
+    if ( !_running )
+      return true;
+
+    /* the writer thread drains the queue, including the partial buffer */
+    if ( _buf_fill )
+      queue_fill_buffer();
+
+    _running = false;
+  }
+  _buf_cond.notify_all();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  if ( rotating() ) {
+    if ( _fd >= 0 )
+      finish_segment();
+
+    {
+      std::lock_guard<std::mutex> lock( _seg_mutex );
+      _closing = false;
+    }
+    _seg_cond.notify_all();
+
+    if ( _closer.joinable() )
+      _closer.join();
+  } else {
+    write_meta();
+  }
+
+  if ( _config.count_clipped && _values ) {
+    std::cerr << boost::format("%s: %d of %d values clipped (%.3f%%)")
+                 % _filename % _clipped % _values
+                 % (100.0 * _clipped / _values)
+              << std::endl;
+  }
+
+  if ( _config.stats || _blocked || _drops.size() ) {
+    uint64_t dropped = 0;
+    for (size_t i = 0; i < _drops.size(); i++)
+      dropped += _drops[i].second;
+
+    std::cerr << boost::format("%s: wrote %.1f MB at %.1f MB/s, "
+                               "peak queue %d/%d buffers, "
+                               "blocked %d times for %.3f s, "
+                               "dropped %d samples in %d runs")
+                 % _filename
+                 % (_written / 1e6)
+                 % (_write_secs > 0 ? _written / _write_secs / 1e6 : 0.0)
+                 % _buf_used_max % _config.buf_num
+                 % _blocked % _blocked_secs
+                 % dropped % _drops.size()
+              << std::endl;
+  }
+
+  return true;
+}
+
+void file_writer_c::set_center_freq( double freq )
+{
+  std::lock_guard<std::mutex> lock( _buf_mutex );
+
+  add_capture( _items_kept, freq, "" );
+}
+
+void file_writer_c::set_sample_rate( double rate )
+{
+  std::lock_guard<std::mutex> lock( _buf_mutex );
+
+  _meta.sample_rate = rate;
+  update_segment_limit();
+}
+
+/* called with _buf_mutex held */
+void file_writer_c::add_capture( uint64_t sample_start, double freq,
+                                 const std::string &datetime )
+{
+  std::vector< sigmf_capture_t > &captures = _meta.captures;
+
+  if ( captures.size() && captures.back().sample_start == sample_start ) {
+    captures.back().frequency = freq;
+    if ( datetime.length() )
+      captures.back().datetime = datetime;
+    return;
+  }
+
+  if ( captures.size() && captures.back().frequency == freq && datetime.empty() )
+    return;
+
+  captures.push_back( sigmf_capture_t( sample_start, freq, datetime ) );
+}
+
+/*
+ * Called with _buf_mutex held.  Samples after the first done ones were
+ * dropped, tags on them apply to the next sample that makes it to disk.
+ */
+void file_writer_c::handle_tags( const std::vector< gr::tag_t > &tags,
+                                 uint64_t items_kept, int done )
+{
+  double freq = _meta.captures.size() ? _meta.captures.back().frequency : 0;
+
+  for ( const gr::tag_t &tag : tags ) {
+    uint64_t rel = std::min< uint64_t >( tag.offset - nitems_read(0), done );
+
+    if ( pmt::eqv( tag.key, FREQ_KEY ) ) {
+      freq = pmt::to_double( tag.value );
+      add_capture( items_kept + rel, freq, "" );
+    } else if ( pmt::eqv( tag.key, TIME_KEY ) ) {
+      add_capture( items_kept + rel, freq,
+                   sigmf_datetime( pmt::to_uint64( pmt::tuple_ref( tag.value, 0 ) ),
+                                   pmt::to_double( pmt::tuple_ref( tag.value, 1 ) ) ) );
+    } else if ( pmt::eqv( tag.key, RATE_KEY ) ) {
+      double rate = pmt::to_double( tag.value );
+
+      if ( _meta.sample_rate > 0 && _meta.sample_rate != rate )
+        std::cerr << "WARNING: " << _filename << ": sample rate changed to "
+                  << rate << ", which SigMF can't describe within one recording."
+                  << std::endl;
+
+      _meta.sample_rate = rate;
+      update_segment_limit();
+    }
+  }
+}
+
+void file_writer_c::write_meta()
+{
+  if ( !_config.sigmf )
+    return;
+
+  sigmf_meta_t meta;
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    meta = segment_meta( _seg_begin, UINT64_MAX );
+  }
+
+  try {
+    sigmf_write( sigmf_meta_filename( _seg_filename ), meta );
+  } catch ( const std::exception &e ) {
+    std::cerr << "WARNING: " << e.what() << std::endl;
+  }
+}
+
+bool file_writer_c::open_index( const std::string &filename, bool append )
+{
+  _index_file = fopen( time_index_filename( filename ).c_str(), append ? "a" : "w" );
+
+  return NULL != _index_file;
+}
+
+/*
+ * Called with _buf_mutex held.  Adds entries for the first sample written
+ * after a start or a gap, for rx_time and rx_freq tags and periodically in
+ * between.  Times are extrapolated from the last rx_time tag, or from the
+ * host clock if the source doesn't provide any.
+ */
+void file_writer_c::update_index( const std::vector< gr::tag_t > &tags,
+                                  uint64_t items_kept, int done, int ninput )
+{
+  uint64_t offset = nitems_read(0);
+
+  if ( !_time_ref && _meta.sample_rate > 0 ) {
+    std::chrono::duration<double> now =
+      std::chrono::system_clock::now().time_since_epoch();
+
+    /* the last sample of this call arrived just now */
+    _time_ref = true;
+    _time_offset = offset + ninput;
+    _time_secs = uint64_t( now.count() );
+    _time_frac = now.count() - _time_secs;
+  }
+
+  if ( _index_pending && done > 0 ) {
+    index_entry( items_kept, offset );
+    _index_pending = false;
+  }
+
+  for ( const gr::tag_t &tag : tags ) {
+    uint64_t rel = tag.offset - offset;
+
+    while ( _index_next < items_kept + std::min< uint64_t >( rel, done ) )
+      index_entry( _index_next, offset + _index_next - items_kept );
+
+    if ( pmt::eqv( tag.key, TIME_KEY ) ) {
+      _time_ref = true;
+      _time_offset = tag.offset;
+      _time_secs = pmt::to_uint64( pmt::tuple_ref( tag.value, 0 ) );
+      _time_frac = pmt::to_double( pmt::tuple_ref( tag.value, 1 ) );
+    } else if ( pmt::eqv( tag.key, FREQ_KEY ) ) {
+      _index_freq = pmt::to_double( tag.value );
+    } else {
+      continue;
+    }
+
+    if ( rel < uint64_t(done) )
+      index_entry( items_kept + rel, tag.offset );
+    else
+      _index_pending = true;
+  }
+
+  while ( _index_next < items_kept + done )
+    index_entry( _index_next, offset + _index_next - items_kept );
+
+  /* the rest was dropped, the samples after the gap need a time of their own */
+  if ( done < ninput )
+    _index_pending = true;
+}
+
+/* called with _buf_mutex held, offset is the position of sample in the stream */
+void file_writer_c::index_entry( uint64_t sample, uint64_t offset )
+{
+  time_index_entry_t entry;
+  double rate = _meta.sample_rate;
+
+  entry.sample = sample;
+  entry.freq = _index_freq;
+
+  if ( _time_ref && ( rate > 0 || offset == _time_offset ) ) {
+    double delta = rate > 0 ? ( double(offset) - double(_time_offset) ) / rate : 0;
+    double frac = _time_frac + delta;
+    double whole = std::floor( frac );
+
+    entry.secs = _time_secs + int64_t( whole );
+    entry.frac = frac - whole;
+  } else {
+    std::chrono::duration<double> now =
+      std::chrono::system_clock::now().time_since_epoch();
+
+    entry.secs = uint64_t( now.count() );
+    entry.frac = now.count() - entry.secs;
+  }
+
+  /* a tag on the first sample after a gap replaces the entry made for it */
+  if ( _index_queue.size() && _index_queue.back().sample == sample )
+    _index_queue.back() = entry;
+  else
+    _index_queue.push_back( entry );
+
+  _index_next = sample + ( rate > 0 ? uint64_t( rate * INDEX_INTERVAL_SECS )
+                                    : INDEX_INTERVAL_ITEMS );
+}
+
+/* appends the entries of the samples on disk by now, called by the writer thread */
+void file_writer_c::write_index()
+{
+  if ( !_index_file )
+    return;
+
+  uint64_t end = _seg_begin + _seg_bytes / _item_size;
+  std::vector< time_index_entry_t > entries;
+  bool seg_start = false;
+  double rate;
+
+  {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+
+    /* a new segment starts with an entry of its own */
+    if ( _index_written && _index_last.sample < _seg_begin &&
+         ( _index_queue.empty() || _index_queue.front().sample > _seg_begin ) ) {
+      time_index_entry_t entry = _index_last;
+      entry.sample = _seg_begin;
+      entries.push_back( entry );
+      seg_start = true;
+    }
+
+    while ( _index_queue.size() && _index_queue.front().sample < end ) {
+      entries.push_back( _index_queue.front() );
+      _index_queue.pop_front();
+    }
+
+    rate = _meta.sample_rate;
+  }
+
+  if ( entries.empty() )
+    return;
+
+  /* extrapolate the segment start from the last entry of the previous one */
+  if ( seg_start && rate > 0 ) {
+    double frac = _index_last.frac + ( _seg_begin - _index_last.sample ) / rate;
+    double whole = std::floor( frac );
+
+    entries[0].secs = _index_last.secs + uint64_t( whole );
+    entries[0].frac = frac - whole;
+  }
+
+  for ( const time_index_entry_t &entry : entries ) {
+    time_index_entry_t rebased = entry;
+    rebased.sample -= _seg_begin;
+
+    fputs( time_index_line( rebased ).c_str(), _index_file );
+  }
+
+  fflush( _index_file );
+
+  _index_last = entries.back();
+  _index_written = true;
+}
+
+std::vector< std::pair< uint64_t, uint64_t > > file_writer_c::drops()
+{
+  std::lock_guard<std::mutex> lock( _buf_mutex );
+
+  return _drops;
+}
+
+/* called with _buf_mutex held */
+void file_writer_c::queue_fill_buffer()
+{
+  size_t fill = (_buf_head + _buf_used) % _config.buf_num;
+
+  _buf_lens[fill] = _buf_fill;
+  _buf_used++;
+  _buf_used_max = std::max( _buf_used_max, _buf_used );
+  _buf_fill = 0;
+
+  _buf_cond.notify_all();
+}
+
+void file_writer_c::_writer_wait( file_writer_c *obj )
+{
+  obj->writer_wait();
+}
+
+void file_writer_c::writer_wait()
+{
+  while (true)
+  {
+    size_t head, len;
+    uint64_t seg_bytes_max;
+
+    {
+      std::unique_lock<std::mutex> lock( _buf_mutex );
+
+      while ( 0 == _buf_used && _running )
+        _buf_cond.wait( lock );
+
+      if ( 0 == _buf_used )
+        break;
+
+      head = _buf_head;
+      len = _buf_lens[head];
+      seg_bytes_max = _seg_bytes_max;
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = write_data( _bufs[head], len, seg_bytes_max );
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    {
+      std::lock_guard<std::mutex> lock( _buf_mutex );
+
+      _written += len;
+      _write_secs += elapsed.count();
+      _buf_head = (_buf_head + 1) % _config.buf_num;
+      _buf_used--;
+
+      if ( !ok )
+        _failed = true;
+    }
+    _buf_cond.notify_all();
+
+    if ( !ok )
+      break;
+  }
+}
+
+/* writes a buffer, switching to the next segment wherever the limit falls */
+bool file_writer_c::write_data( const unsigned char *buf, size_t len,
+                                uint64_t seg_bytes_max )
+{
+  if ( _fd < 0 )
+    return false;
+
+  while ( len ) {
+    size_t chunk = len;
+
+    if ( seg_bytes_max ) {
+      /* rotate lazily, so stopping never leaves an empty segment behind */
+      if ( _seg_bytes >= seg_bytes_max ) {
+        finish_segment();
+
+        if ( !open_segment() ) {
+          std::cerr << "Failed to open " << _seg_filename << ": "
+                    << strerror(errno) << std::endl;
+          return false;
+        }
+      }
+
+      chunk = std::min< uint64_t >( len, seg_bytes_max - _seg_bytes );
+    }
+
+    if ( !write_buffer( buf, chunk ) )
+      return false;
+
+    _seg_bytes += chunk;
+    buf += chunk;
+    len -= chunk;
+
+    write_index();
+  }
+
+  return true;
+}
+
+bool file_writer_c::write_buffer( const unsigned char *buf, size_t len )
+{
+#ifdef O_DIRECT
+  /* only the last buffer may be short, finish it through the page cache */
+  if ( _direct && len % FILE_WRITER_ALIGNMENT ) {
+    fcntl( _fd, F_SETFL, fcntl( _fd, F_GETFL ) & ~O_DIRECT );
+    _direct = false;
+  }
+#endif
+
+  while ( len ) {
+    ssize_t ret = write( _fd, buf, len );
+    if ( ret < 0 ) {
+      if ( EINTR == errno )
+        continue;
+
+      std::cerr << "Failed to write " << _filename << ": "
+                << strerror(errno) << std::endl;
+      return false;
+    }
+
+    buf += ret;
+    len -= ret;
+  }
+
+  return true;
+}
+
+void file_writer_c::_closer_wait( file_writer_c *obj )
+{
+  obj->closer_wait();
+}
+
+void file_writer_c::closer_wait()
+{
+  while (true)
+  {
+    segment_t seg;
+
+    {
+      std::unique_lock<std::mutex> lock( _seg_mutex );
+
+      while ( _seg_queue.empty() && _closing )
+        _seg_cond.wait( lock );
+
+      if ( _seg_queue.empty() )
+        break;
+
+      seg = _seg_queue.front();
+      _seg_queue.pop_front();
+    }
+
+    close_segment( seg );
+  }
+}
+
+void file_writer_c::close_segment( segment_t &seg )
+{
+#ifdef _WIN32
+  _commit( seg.fd );
+#else
+  fsync( seg.fd );
+#endif
+  close( seg.fd );
+
+  if ( _config.sigmf ) {
+    try {
+      sigmf_write( sigmf_meta_filename( seg.filename ), seg.meta );
+    } catch ( const std::exception &e ) {
+      std::cerr << "WARNING: " << e.what() << std::endl;
+    }
+  }
+
+  _seg_done.push_back( std::make_pair( seg.filename, seg.bytes ) );
+  _seg_done_bytes += seg.bytes;
+
+  if ( !_config.max_total )
+    return;
+
+  /*
+   * Leave room for the segment being written, assuming it ends up as big.
+   * The one just finished is kept even if that alone exceeds the cap.
+   */
+  while ( _seg_done.size() > 1 && _seg_done_bytes + seg.bytes > _config.max_total ) {
+    const std::string &filename = _seg_done.front().first;
+
+    if ( 0 != std::remove( filename.c_str() ) )
+      std::cerr << "WARNING: Failed to delete " << filename << ": "
+                << strerror(errno) << std::endl;
+
+    if ( _config.sigmf )
+      std::remove( sigmf_meta_filename( filename ).c_str() );
+
+    if ( _config.index )
+      std::remove( time_index_filename( filename ).c_str() );
+
+    _seg_done_bytes -= _seg_done.front().second;
+    _seg_done.pop_front();
+  }
+}
+
+/* converts count frames of all inputs into buf, called without _buf_mutex */
+size_t file_writer_c::convert( unsigned char *buf, gr_vector_const_void_star &input_items,
+                               size_t offset, size_t count )
+{
+  if ( 1 == _config.nchan )
+    return iq_format_from_complex( buf, (const gr_complex *)input_items[0] + offset,
+                                   count, _config.format, _config.count_clipped );
+
+  size_t clipped = 0;
+
+  for (size_t done = 0; done < count; ) {
+    size_t n = std::min< size_t >( count - done, INTERLEAVE_FRAMES );
+
+    for (size_t c = 0; c < _config.nchan; c++)
+      _chans[c] = (const gr_complex *)input_items[c] + offset + done;
+
+    /* cf32 needs no conversion, interleave straight into the buffer */
+    if ( IQ_FORMAT_CF32 == _config.format ) {
+      iq_interleave( (gr_complex *)( buf + done * _item_size ), _chans.data(),
+                     n, _config.nchan );
+    } else {
+      iq_interleave( _frames, _chans.data(), n, _config.nchan );
+      clipped += iq_format_from_complex( buf + done * _item_size, _frames,
+                                         n * _config.nchan, _config.format,
+                                         _config.count_clipped );
+    }
+
+    done += n;
+  }
+
+  return clipped;
+}
+
+int file_writer_c::work( int noutput_items,
+                         gr_vector_const_void_star &input_items,
+                         gr_vector_void_star &output_items )
+{
+  int done = 0;
+
+  std::vector< gr::tag_t > tags;
+  if ( _track_meta )
+    get_tags_in_range( tags, 0, nitems_read(0), nitems_read(0) + noutput_items );
+
+  std::unique_lock<std::mutex> lock( _buf_mutex );
+
+  uint64_t items_kept = _items_kept;
+
+  while ( done < noutput_items ) {
+    if ( _failed )
+      return WORK_DONE;
+
+    /* the buffer is full and every other one is still queued for writing */
+    if ( _config.buf_size - _buf_fill < _item_size ) {
+      if ( _buf_used + 1 < _config.buf_num ) {
+        queue_fill_buffer();
+      } else if ( _config.drop ) {
+        uint64_t offset = nitems_read(0) + done;
+        uint64_t count = noutput_items - done;
+
+        if ( _drops.size() && _drops.back().first + _drops.back().second == offset ) {
+          _drops.back().second += count;
+        } else {
+          _drops.push_back( std::make_pair( offset, count ) );
+          std::cerr << "D" << std::flush;
+
+          if ( _config.sigmf ) {
+            sigmf_annotation_t annotation;
+            annotation.sample_start = _items_kept;
+            _meta.annotations.push_back( annotation );
+          }
+        }
+
+        if ( _config.sigmf )
+          _meta.annotations.back().comment =
+            str( boost::format("%d samples dropped") % _drops.back().second );
+
+        break;
+      } else {
+        auto begin = std::chrono::steady_clock::now();
+
+        while ( _buf_used + 1 >= _config.buf_num && !_failed )
+          _buf_cond.wait( lock );
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+        _blocked++;
+        _blocked_secs += elapsed.count();
+
+        continue;
+      }
+    }
+
+    size_t fill = (_buf_head + _buf_used) % _config.buf_num;
+    unsigned char *buf = _bufs[fill] + _buf_fill;
+    size_t count = std::min< size_t >( noutput_items - done,
+                                       (_config.buf_size - _buf_fill) / _item_size );
+
+    /* the fill buffer belongs to work(), the writer never touches it */
+    lock.unlock();
+
+    size_t clipped = convert( buf, input_items, done, count );
+
+    lock.lock();
+
+    if ( clipped && 0 == _clipped )
+      std::cerr << "WARNING: " << _filename << " is clipping, "
+                << "consider lowering the gain." << std::endl;
+
+    _clipped += clipped;
+    if ( IQ_FORMAT_CF32 != _config.format )
+      _values += 2 * count * _config.nchan;
+
+    _buf_fill += count * _item_size;
+    _items_kept += count;
+    done += count;
+  }
+
+  handle_tags( tags, items_kept, done );
+
+  if ( _config.index )
+    update_index( tags, items_kept, done, noutput_items );
+
+  return noutput_items;
+}
@@ -0,0 +1,254 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef FILE_WRITER_C_H
+#define FILE_WRITER_C_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/thread/thread.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <ctime>
+#include <cstdio>
+
+#include "iq_format.h"
+#include "sigmf.h"
+#include "time_index.h"
+
+/* buffers are aligned and sized in multiples of this for O_DIRECT */
+#define FILE_WRITER_ALIGNMENT 4096
+
+struct file_writer_config_t
+{
+  file_writer_config_t() :
+    format(IQ_FORMAT_CF32),
+    nchan(1),
+    append(false),
+    count_clipped(false),
+    buf_num(8),
+    buf_size(4 * 1024 * 1024),
+    direct(false),
+    prealloc(0),
+    drop(false),
+    stats(false),
+    sigmf(false),
+    sample_rate(0),
+    center_freq(0),
+    rotate_bytes(0),
+    rotate_secs(0),
+    max_total(0),
+    index(false)
+  {}
+
+  iq_format_t format;
+  size_t nchan;       /* inputs, interleaved sample by sample in the file */
+  bool append;
+  bool count_clipped;
+  size_t buf_num;     /* buffers between work() and the writer thread */
+  size_t buf_size;    /* bytes per buffer, rounded up to the alignment */
+  bool direct;        /* bypass the page cache with O_DIRECT */
+  uint64_t prealloc;  /* bytes reserved up front with fallocate */
+  bool drop;          /* drop samples instead of blocking when all buffers are full */
+  bool stats;         /* always print the writer statistics on stop() */
+  bool sigmf;         /* maintain a .sigmf-meta file next to the data */
+  double sample_rate; /* initial metadata, see set_sample_rate() */
+  double center_freq; /* and set_center_freq() */
+
+  /*
+   * Rotation: start a new file once the current one holds rotate_bytes or
+   * rotate_secs worth of samples.  The file name is then a template, see
+   * above, with %t being the time the segment was opened.  Once finished
+   * segments exceed max_total bytes the oldest ones are deleted.
+   */
+  uint64_t rotate_bytes;
+  double rotate_secs;
+  uint64_t max_total;
+
+  bool index;         /* maintain a time index next to the data, see time_index.h */
+};
+
+/*
+ * File name templates: %n expands to the sequence number, %t to the given
+ * UTC time and %f to the center frequency in Hz.  file_name_template()
+ * inserts _%n before the extension if the name doesn't use it already.
+ */
+std::string file_name_template( const std::string &filename );
+std::string expand_file_name( const std::string &tmpl, uint64_t seq,
+                              double freq, time_t now );
+
+class file_writer_c;
+
+typedef std::shared_ptr< file_writer_c > file_writer_c_sptr;
+
+file_writer_c_sptr make_file_writer_c( const std::string &filename,
+                                       const file_writer_config_t &config );
+
+/*
+ * IQ file writer.  Incoming samples are converted into the requested
+ * on-disk format and collected in large aligned buffers, which a separate
+ * thread writes to disk.  Writeback stalls therefore don't hold up the
+ * scheduler unless all buffers are in flight; then work() either blocks or
+ * drops the samples, depending on the configured policy.
+ *
+ * With rotation enabled the writer thread switches files at exact sample
+ * boundaries and hands finished segments to a second thread, which syncs
+ * and closes them, writes their metadata and enforces the disk usage cap.
+ */
+class file_writer_c : public gr::sync_block
+{
+private:
+  friend file_writer_c_sptr make_file_writer_c( const std::string &filename,
+                                                const file_writer_config_t &config );
+
+  file_writer_c( const std::string &filename, const file_writer_config_t &config );
+
+public:
+  ~file_writer_c();
+
+  bool start();
+  bool stop();
+
+  /* number of saturated I and Q values, only counted if enabled */
+  uint64_t clipped() const { return _clipped; }
+
+  /*
+   * Start a new capture segment at the next sample written.  Segments are
+   * also started by rx_freq and rx_time tags, rx_rate tags update the
+   * sample rate.
+   */
+  void set_center_freq( double freq );
+  void set_sample_rate( double rate );
+
+  /* sample offset and length of every run of dropped samples */
+  std::vector< std::pair< uint64_t, uint64_t > > drops();
+
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+private:
+  struct segment_t
+  {
+    int fd;
+    std::string filename;
+    uint64_t bytes;
+    sigmf_meta_t meta;
+  };
+
+  static void _writer_wait( file_writer_c *obj );
+  void writer_wait();
+  bool write_data( const unsigned char *buf, size_t len, uint64_t seg_bytes_max );
+  bool write_buffer( const unsigned char *buf, size_t len );
+  size_t convert( unsigned char *buf, gr_vector_const_void_star &input_items,
+                  size_t offset, size_t count );
+
+  static void _closer_wait( file_writer_c *obj );
+  void closer_wait();
+  void close_segment( segment_t &seg );
+
+  bool rotating() const { return _config.rotate_bytes || _config.rotate_secs > 0; }
+  int open_file( const std::string &filename, bool append );
+  bool open_segment();
+  void finish_segment();
+  void update_segment_limit();
+  sigmf_meta_t segment_meta( uint64_t begin, uint64_t end );
+  void queue_fill_buffer();
+  void add_capture( uint64_t sample_start, double freq, const std::string &datetime );
+  void handle_tags( const std::vector< gr::tag_t > &tags, uint64_t items_kept, int done );
+  void write_meta();
+
+  bool open_index( const std::string &filename, bool append );
+  void update_index( const std::vector< gr::tag_t > &tags, uint64_t items_kept,
+                     int done, int ninput );
+  void index_entry( uint64_t sample, uint64_t offset );
+  void write_index();
+
+  std::string _filename;
+  file_writer_config_t _config;
+  size_t _item_size;  /* bytes per sample time, of all channels */
+  int _fd;
+  bool _direct;       /* O_DIRECT in use, owned by the writer thread while running */
+
+  /* work()'s conversion buffer for interleaving multiple channels */
+  gr_complex *_frames;
+  std::vector< const gr_complex * > _chans;
+
+  gr::thread::thread _thread;
+  std::mutex _buf_mutex;
+  std::condition_variable _buf_cond;
+  bool _running;
+  bool _failed;
+
+  std::vector< unsigned char * > _bufs;
+  std::vector< size_t > _buf_lens;
+  size_t _buf_head;
+  size_t _buf_used;
+  size_t _buf_fill;   /* bytes in the buffer work() is currently filling */
+
+  sigmf_meta_t _meta;
+  bool _track_meta;
+  uint64_t _items_kept; /* samples written so far, the next one goes here */
+
+  /* the file currently written, owned by the writer thread while running */
+  std::string _seg_filename;
+  uint64_t _seg_seq;
+  uint64_t _seg_begin;      /* index of its first sample */
+  uint64_t _seg_bytes;
+  uint64_t _seg_bytes_max;  /* protected by _buf_mutex */
+
+  /* finished segments waiting for the closer thread */
+  gr::thread::thread _closer;
+  std::mutex _seg_mutex;
+  std::condition_variable _seg_cond;
+  std::deque< segment_t > _seg_queue;
+  bool _closing;
+  std::deque< std::pair< std::string, uint64_t > > _seg_done;
+  uint64_t _seg_done_bytes;
+
+  uint64_t _clipped;
+  uint64_t _values;
+
+  /* back-pressure statistics */
+  size_t _buf_used_max;
+  uint64_t _blocked;
+  double _blocked_secs;
+  uint64_t _written;
+  double _write_secs;
+  std::vector< std::pair< uint64_t, uint64_t > > _drops;
+
+  /* time index, entries wait in the queue until their samples are on disk */
+  std::deque< time_index_entry_t > _index_queue;
+  bool _index_pending;    /* the next sample written needs an entry */
+  uint64_t _index_next;   /* sample of the next periodic entry */
+  double _index_freq;
+  bool _time_ref;         /* the reference below is valid */
+  uint64_t _time_offset;  /* stream offset of the reference time */
+  uint64_t _time_secs;
+  double _time_frac;
+  FILE *_index_file;      /* owned by the writer thread while running */
+  time_index_entry_t _index_last;
+  bool _index_written;
+};
+
+#endif // FILE_WRITER_C_H
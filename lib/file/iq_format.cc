@@ -0,0 +1,367 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <volk/volk.h>
+
+#include "iq_format.h"
+
+/* same DC offset as rtl_source_c so replayed captures match live ones */
+#define CU8_OFFSET 127.4f
+
+iq_format_t iq_format_from_string( const std::string &name )
+{
+  if ( "cu8" == name )
+    return IQ_FORMAT_CU8;
+  if ( "cs8" == name )
+    return IQ_FORMAT_CS8;
+  if ( "cs16" == name )
+    return IQ_FORMAT_CS16;
+  if ( "cf32" == name )
+    return IQ_FORMAT_CF32;
+
+  throw std::runtime_error( "Unsupported sample format '" + name +
+                            "', expected cu8, cs8, cs16 or cf32." );
+}
+
+std::string iq_format_to_string( iq_format_t format )
+{
+  switch ( format ) {
+  case IQ_FORMAT_CU8:  return "cu8";
+  case IQ_FORMAT_CS8:  return "cs8";
+  case IQ_FORMAT_CS16: return "cs16";
+  case IQ_FORMAT_CF32: return "cf32";
+  }
+  return "";
+}
+
+iq_format_t iq_format_from_filename( const std::string &filename,
+                                     iq_format_t fallback )
+{
+  size_t dot = filename.find_last_of('.');
+  if ( dot == std::string::npos )
+    return fallback;
+
+  std::string ext = filename.substr(dot + 1);
+  if ( ext == "cu8" || ext == "cs8" || ext == "cs16" )
+    return iq_format_from_string( ext );
+
+  return fallback;
+}
+
+size_t iq_format_size( iq_format_t format )
+{
+  switch ( format ) {
+  case IQ_FORMAT_CU8:  return 2 * sizeof(uint8_t);
+  case IQ_FORMAT_CS8:  return 2 * sizeof(int8_t);
+  case IQ_FORMAT_CS16: return 2 * sizeof(int16_t);
+  case IQ_FORMAT_CF32: return sizeof(gr_complex);
+  }
+  return 0;
+}
+
+static void cu8_to_float_default( float *out, const uint8_t *in, size_t count )
+{
+  for (size_t i = 0; i < count; i++)
+    out[i] = (float(in[i]) - CU8_OFFSET) * (1.0f/128.0f);
+}
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+/* count is in blocks of 16 values */
+static void cu8_to_float_sse2( float *out, const uint8_t *in, size_t count )
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128 offset = _mm_set1_ps( CU8_OFFSET );
+  const __m128 scale = _mm_set1_ps( 1.0f/128.0f );
+
+  for (size_t i = 0; i < count; i++) {
+    __m128i bytes = _mm_loadu_si128((const __m128i *)&in[i*16]);
+
+    /* zero extend to 16 and then 32 bit lanes */
+    __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+    __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+
+    __m128 f0 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero));
+    __m128 f1 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero));
+    __m128 f2 = _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero));
+    __m128 f3 = _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero));
+
+    _mm_storeu_ps(&out[i*16 + 0],  _mm_mul_ps(_mm_sub_ps(f0, offset), scale));
+    _mm_storeu_ps(&out[i*16 + 4],  _mm_mul_ps(_mm_sub_ps(f1, offset), scale));
+    _mm_storeu_ps(&out[i*16 + 8],  _mm_mul_ps(_mm_sub_ps(f2, offset), scale));
+    _mm_storeu_ps(&out[i*16 + 12], _mm_mul_ps(_mm_sub_ps(f3, offset), scale));
+  }
+}
+#endif
+
+static void cu8_to_float( float *out, const uint8_t *in, size_t count )
+{
+#if defined(USE_SSE2) || defined(USE_AVX)
+  size_t sse_rem = count/16;
+  size_t nosse_rem = count%16;
+
+  cu8_to_float_sse2(out, in, sse_rem);
+  cu8_to_float_default(out + sse_rem*16, in + sse_rem*16, nosse_rem);
+#else
+  cu8_to_float_default(out, in, count);
+#endif
+}
+
+void iq_format_to_complex( gr_complex *out, const void *in, size_t nitems,
+                           iq_format_t format )
+{
+  switch ( format ) {
+  case IQ_FORMAT_CU8:
+    cu8_to_float( (float *)out, (const uint8_t *)in, 2 * nitems );
+    break;
+  case IQ_FORMAT_CS8:
+    volk_8i_s32f_convert_32f( (float *)out, (const int8_t *)in, 128.0f, 2 * nitems );
+    break;
+  case IQ_FORMAT_CS16:
+    volk_16i_s32f_convert_32f( (float *)out, (const int16_t *)in, 32768.0f, 2 * nitems );
+    break;
+  case IQ_FORMAT_CF32:
+    memcpy( out, in, nitems * sizeof(gr_complex) );
+    break;
+  }
+}
+
+static void float_to_cu8_default( uint8_t *out, const float *in, size_t count )
+{
+  for (size_t i = 0; i < count; i++) {
+    long v = lrintf(in[i] * 128.0f + CU8_OFFSET);
+    out[i] = (uint8_t)std::min(std::max(v, 0L), 255L);
+  }
+}
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+/* count is in blocks of 16 values */
+static void float_to_cu8_sse2( uint8_t *out, const float *in, size_t count )
+{
+  const __m128 offset = _mm_set1_ps( CU8_OFFSET );
+  const __m128 scale = _mm_set1_ps( 128.0f );
+
+  for (size_t i = 0; i < count; i++) {
+    __m128i i0 = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in[i*16 + 0]), scale), offset));
+    __m128i i1 = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in[i*16 + 4]), scale), offset));
+    __m128i i2 = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in[i*16 + 8]), scale), offset));
+    __m128i i3 = _mm_cvtps_epi32(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&in[i*16 + 12]), scale), offset));
+
+    /* saturating narrow to 16 bit signed and then 8 bit unsigned */
+    __m128i lo = _mm_packs_epi32(i0, i1);
+    __m128i hi = _mm_packs_epi32(i2, i3);
+
+    _mm_storeu_si128((__m128i *)&out[i*16], _mm_packus_epi16(lo, hi));
+  }
+}
+#endif
+
+static void float_to_cu8( uint8_t *out, const float *in, size_t count )
+{
+#if defined(USE_SSE2) || defined(USE_AVX)
+  size_t sse_rem = count/16;
+  size_t nosse_rem = count%16;
+
+  float_to_cu8_sse2(out, in, sse_rem);
+  float_to_cu8_default(out + sse_rem*16, in + sse_rem*16, nosse_rem);
+#else
+  float_to_cu8_default(out, in, count);
+#endif
+}
+
+/* counts values which would saturate, i.e. fall outside [lo, hi] */
+static size_t count_outside( const float *in, size_t count, float lo, float hi )
+{
+  size_t clipped = 0;
+  size_t i = 0;
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  const __m128 vlo = _mm_set1_ps( lo );
+  const __m128 vhi = _mm_set1_ps( hi );
+
+  for (; i + 4 <= count; i += 4) {
+    __m128 v = _mm_loadu_ps(&in[i]);
+    int mask = _mm_movemask_ps(_mm_or_ps(_mm_cmplt_ps(v, vlo), _mm_cmpgt_ps(v, vhi)));
+    if (mask)
+      clipped += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + ((mask >> 3) & 1);
+  }
+#endif
+
+  for (; i < count; i++)
+    if (in[i] < lo || in[i] > hi)
+      clipped++;
+
+  return clipped;
+}
+
+size_t iq_format_from_complex( void *out, const gr_complex *in, size_t nitems,
+                               iq_format_t format, bool count_clipped )
+{
+  const float *fin = (const float *)in;
+  size_t clipped = 0;
+
+  /* bounds are chosen so that exactly the values that round out of range count */
+  switch ( format ) {
+  case IQ_FORMAT_CU8:
+    if ( count_clipped )
+      clipped = count_outside( fin, 2 * nitems,
+                               (-0.5f - CU8_OFFSET) / 128.0f,
+                               (255.5f - CU8_OFFSET) / 128.0f );
+    float_to_cu8( (uint8_t *)out, fin, 2 * nitems );
+    break;
+  case IQ_FORMAT_CS8:
+    if ( count_clipped )
+      clipped = count_outside( fin, 2 * nitems, -128.5f / 128.0f, 127.5f / 128.0f );
+    volk_32f_s32f_convert_8i( (int8_t *)out, fin, 128.0f, 2 * nitems );
+    break;
+  case IQ_FORMAT_CS16:
+    if ( count_clipped )
+      clipped = count_outside( fin, 2 * nitems, -32768.5f / 32768.0f, 32767.5f / 32768.0f );
+    volk_32f_s32f_convert_16i( (int16_t *)out, fin, 32768.0f, 2 * nitems );
+    break;
+  case IQ_FORMAT_CF32:
+    memcpy( out, in, nitems * sizeof(gr_complex) );
+    break;
+  }
+
+  return clipped;
+}
+
+static void deinterleave_default( gr_complex * const *out, const gr_complex *in,
+                                  size_t first, size_t nframes, size_t nchan )
+{
+  for (size_t f = first; f < nframes; f++)
+    for (size_t c = 0; c < nchan; c++)
+      out[c][f] = in[f*nchan + c];
+}
+
+static void interleave_default( gr_complex *out, const gr_complex * const *in,
+                                size_t first, size_t nframes, size_t nchan )
+{
+  for (size_t f = first; f < nframes; f++)
+    for (size_t c = 0; c < nchan; c++)
+      out[f*nchan + c] = in[c][f];
+}
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+/*
+ * A complex sample fills half an SSE register, so two frames of a channel
+ * pair form a 2x2 transpose: one unpacklo/unpackhi each.  count is in
+ * pairs of frames, nchan must be even.
+ */
+static void deinterleave_sse2( gr_complex * const *out, const gr_complex *in,
+                               size_t count, size_t nchan )
+{
+  for (size_t i = 0; i < count; i++) {
+    const double *f0 = (const double *)&in[2*i*nchan];
+    const double *f1 = (const double *)&in[(2*i + 1)*nchan];
+
+    for (size_t c = 0; c < nchan; c += 2) {
+      __m128d a = _mm_loadu_pd(&f0[c]);
+      __m128d b = _mm_loadu_pd(&f1[c]);
+
+      _mm_storeu_pd((double *)&out[c][2*i], _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd((double *)&out[c + 1][2*i], _mm_unpackhi_pd(a, b));
+    }
+  }
+}
+
+static void interleave_sse2( gr_complex *out, const gr_complex * const *in,
+                             size_t count, size_t nchan )
+{
+  for (size_t i = 0; i < count; i++) {
+    double *f0 = (double *)&out[2*i*nchan];
+    double *f1 = (double *)&out[(2*i + 1)*nchan];
+
+    for (size_t c = 0; c < nchan; c += 2) {
+      __m128d a = _mm_loadu_pd((const double *)&in[c][2*i]);
+      __m128d b = _mm_loadu_pd((const double *)&in[c + 1][2*i]);
+
+      _mm_storeu_pd(&f0[c], _mm_unpacklo_pd(a, b));
+      _mm_storeu_pd(&f1[c], _mm_unpackhi_pd(a, b));
+    }
+  }
+}
+#endif
+
+void iq_deinterleave( gr_complex * const *out, const gr_complex *in,
+                      size_t nframes, size_t nchan )
+{
+  if ( 1 == nchan ) {
+    memcpy( out[0], in, nframes * sizeof(gr_complex) );
+    return;
+  }
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  if ( 0 == nchan % 2 ) {
+    deinterleave_sse2( out, in, nframes/2, nchan );
+    deinterleave_default( out, in, nframes/2*2, nframes, nchan );
+    return;
+  }
+#endif
+
+  deinterleave_default( out, in, 0, nframes, nchan );
+}
+
+void iq_interleave( gr_complex *out, const gr_complex * const *in,
+                    size_t nframes, size_t nchan )
+{
+  if ( 1 == nchan ) {
+    memcpy( out, in[0], nframes * sizeof(gr_complex) );
+    return;
+  }
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  if ( 0 == nchan % 2 ) {
+    interleave_sse2( out, in, nframes/2, nchan );
+    interleave_default( out, in, nframes/2*2, nframes, nchan );
+    return;
+  }
+#endif
+
+  interleave_default( out, in, 0, nframes, nchan );
+}
+
+std::string channel_file_name( const std::string &tmpl, size_t chan )
+{
+  std::string out = tmpl;
+  size_t pos = 0;
+
+  while ( std::string::npos != ( pos = out.find( "%c", pos ) ) ) {
+    std::string num = std::to_string( chan );
+    out.replace( pos, 2, num );
+    pos += num.size();
+  }
+
+  return out;
+}
@@ -0,0 +1,83 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef IQ_FORMAT_H
+#define IQ_FORMAT_H
+
+#include <string>
+#include <cstddef>
+
+#include <gnuradio/gr_complex.h>
+
+/*
+ * On-disk sample formats understood by the file source and sink.  All of
+ * them store interleaved I/Q pairs in host (little endian) byte order.
+ *
+ *   cu8   unsigned 8 bit, as written by rtl_sdr
+ *   cs8   signed 8 bit, as written by hackrf_transfer
+ *   cs16  signed 16 bit
+ *   cf32  32 bit float, the native gr_complex layout
+ */
+enum iq_format_t {
+  IQ_FORMAT_CU8,
+  IQ_FORMAT_CS8,
+  IQ_FORMAT_CS16,
+  IQ_FORMAT_CF32
+};
+
+/* throws std::runtime_error for unknown names */
+iq_format_t iq_format_from_string( const std::string &name );
+std::string iq_format_to_string( iq_format_t format );
+
+/* guesses the format from the extension used by rtl_sdr, hackrf_transfer & co */
+iq_format_t iq_format_from_filename( const std::string &filename,
+                                     iq_format_t fallback = IQ_FORMAT_CF32 );
+
+/* size of one complex sample in bytes */
+size_t iq_format_size( iq_format_t format );
+
+/* converts nitems complex samples into gr_complex scaled to +-1.0 */
+void iq_format_to_complex( gr_complex *out, const void *in, size_t nitems,
+                           iq_format_t format );
+
+/*
+ * converts nitems gr_complex samples into the on-disk format.  Values
+ * outside the representable range saturate; if count_clipped is set the
+ * number of saturated I and Q values is returned, otherwise 0.
+ */
+size_t iq_format_from_complex( void *out, const gr_complex *in, size_t nitems,
+                               iq_format_t format, bool count_clipped = false );
+
+/*
+ * Multi-channel recordings either interleave the channels sample by
+ * sample in one file or keep one file per channel.  These split nframes
+ * frames of nchan interleaved samples into one buffer per channel and
+ * join them again.
+ */
+void iq_deinterleave( gr_complex * const *out, const gr_complex *in,
+                      size_t nframes, size_t nchan );
+void iq_interleave( gr_complex *out, const gr_complex * const *in,
+                    size_t nframes, size_t nchan );
+
+/* replaces %c in a per-channel file name template with the channel number */
+std::string channel_file_name( const std::string &tmpl, size_t chan );
+
+#endif // IQ_FORMAT_H
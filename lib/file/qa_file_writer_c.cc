@@ -0,0 +1,201 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Streams a counter through file_writer_c with rotation enabled and checks
+ * that the segments concatenate back to the counter, i.e. that no sample
+ * is lost or duplicated across segment boundaries.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <gnuradio/top_block.h>
+#include <gnuradio/blocks/vector_source.h>
+
+#include "file_writer_c.h"
+
+#define NSAMPLES 300000
+
+static int failures = 0;
+
+static void fail( const std::string &test, const std::string &what )
+{
+  std::cerr << test << ": " << what << std::endl;
+  failures++;
+}
+
+static std::vector< char > read_file( const std::string &filename, bool &exists )
+{
+  std::vector< char > data;
+  FILE *fp = fopen( filename.c_str(), "rb" );
+
+  exists = NULL != fp;
+  if ( !fp )
+    return data;
+
+  char buf[65536];
+  size_t len;
+  while ( ( len = fread( buf, 1, sizeof(buf), fp ) ) > 0 )
+    data.insert( data.end(), buf, buf + len );
+
+  fclose( fp );
+
+  return data;
+}
+
+/* channel c of sample i is (i, c), exact in float for the counts used here */
+static gr_complex counter( size_t i, size_t c )
+{
+  return gr_complex( float(i), float(c) );
+}
+
+static void run_rotation( const std::string &test, const std::string &dir,
+                          file_writer_config_t config, bool expect_all )
+{
+  std::string tmpl = dir + "/" + test + "_%n.cf32";
+
+  gr::top_block_sptr tb = gr::make_top_block( test );
+  file_writer_c_sptr writer = make_file_writer_c( tmpl, config );
+
+  for (size_t c = 0; c < config.nchan; c++) {
+    std::vector< gr_complex > data( NSAMPLES );
+    for (size_t i = 0; i < NSAMPLES; i++)
+      data[i] = counter( i, c );
+
+    tb->connect( gr::blocks::vector_source_c::make( data ), 0, writer, c );
+  }
+
+  tb->run();
+  writer.reset();
+
+  size_t item_size = config.nchan * sizeof(gr_complex);
+  std::vector< gr_complex > samples;
+  std::vector< size_t > sizes;
+
+  /* with a cap the oldest segments are gone, collect the ones that are left */
+  for (size_t seq = 0; seq < NSAMPLES; seq++) {
+    bool exists;
+    std::string filename = expand_file_name( tmpl, seq, 0, 0 );
+    std::vector< char > data = read_file( filename, exists );
+
+    if ( !exists ) {
+      if ( sizes.size() )
+        break;
+      if ( expect_all ) {
+        fail( test, filename + " is missing" );
+        break;
+      }
+      continue;
+    }
+
+    sizes.push_back( data.size() );
+
+    const gr_complex *p = (const gr_complex *)data.data();
+    samples.insert( samples.end(), p, p + data.size() / sizeof(gr_complex) );
+
+    std::remove( filename.c_str() );
+  }
+
+  if ( expect_all && sizes.size() < 2 )
+    fail( test, "expected the recording to be split" );
+
+  for (size_t i = 0; i < sizes.size(); i++) {
+    if ( sizes[i] % item_size )
+      fail( test, "segment " + std::to_string( i ) + " doesn't hold whole frames" );
+
+    if ( config.direct && i + 1 < sizes.size() && sizes[i] % FILE_WRITER_ALIGNMENT )
+      fail( test, "segment " + std::to_string( i ) + " isn't a whole number of blocks" );
+  }
+
+  /* whatever is left has to be the end of the counter, without gaps */
+  size_t nframes = samples.size() / config.nchan;
+  if ( expect_all && nframes != NSAMPLES )
+    fail( test, "expected " + std::to_string( NSAMPLES ) + " samples, got " +
+                std::to_string( nframes ) );
+
+  if ( 0 == nframes )
+    fail( test, "no samples left" );
+
+  if ( nframes > NSAMPLES ) {
+    fail( test, "more samples than were written" );
+    return;
+  }
+
+  size_t offset = NSAMPLES - nframes;
+  for (size_t i = 0; i < nframes; i++) {
+    for (size_t c = 0; c < config.nchan; c++) {
+      if ( samples[i * config.nchan + c] != counter( offset + i, c ) ) {
+        fail( test, "sample " + std::to_string( offset + i ) + " of channel " +
+                    std::to_string( c ) + " doesn't match" );
+        return;
+      }
+    }
+  }
+}
+
+int main()
+{
+  char dir[] = "/tmp/qa_file_writer_c_XXXXXX";
+
+  if ( !mkdtemp( dir ) ) {
+    std::cerr << "Failed to create a temporary directory: " << strerror(errno) << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  file_writer_config_t config;
+  config.buf_size = 65536;   /* segments end in the middle of buffers */
+  config.buf_num = 4;
+  config.rotate_bytes = 100003;
+
+  run_rotation( "single", dir, config, true );
+
+  /* frames of 24 bytes, the limit has to be rounded to whole frames and blocks */
+  config.nchan = 3;
+  config.direct = true;
+  config.rotate_bytes = 50000;
+  run_rotation( "direct", dir, config, true );
+
+  /* a cap below two segments keeps at least the newest finished one */
+  config.nchan = 1;
+  config.direct = false;
+  config.rotate_bytes = 100003;
+  config.max_total = 150000;
+  run_rotation( "capped", dir, config, false );
+
+  rmdir( dir );
+
+  if ( failures ) {
+    std::cerr << failures << " failures" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
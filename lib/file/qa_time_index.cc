@@ -0,0 +1,199 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+/*
+ * Checks time_index lookups against a large index, including that they
+ * take logarithmic time, and the capture segments derived from it.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "time_index.h"
+
+#define RATE 1e6
+#define NENTRIES 100000
+#define NLOOKUPS 100000
+#define EPOCH 1700000000
+
+static int failures = 0;
+
+static void check( bool ok, const std::string &what )
+{
+  if ( !ok ) {
+    std::cerr << what << std::endl;
+    failures++;
+  }
+}
+
+static std::string write_index( const std::vector< time_index_entry_t > &entries,
+                                const std::string &tail )
+{
+  char filename[] = "/tmp/qa_time_index_XXXXXX";
+  int fd = mkstemp( filename );
+  FILE *fp = fd >= 0 ? fdopen( fd, "w" ) : NULL;
+
+  if ( !fp ) {
+    std::cerr << "Failed to create a temporary file." << std::endl;
+    exit( EXIT_FAILURE );
+  }
+
+  for ( const time_index_entry_t &entry : entries )
+    fputs( time_index_line( entry ).c_str(), fp );
+  fputs( tail.c_str(), fp );
+  fclose( fp );
+
+  return filename;
+}
+
+static time_index_entry_t entry( uint64_t sample, uint64_t secs, double frac, double freq )
+{
+  time_index_entry_t e;
+
+  e.sample = sample;
+  e.secs = secs;
+  e.frac = frac;
+  e.freq = freq;
+
+  return e;
+}
+
+/* one entry per second of a gapless recording at RATE */
+static void test_lookup()
+{
+  std::vector< time_index_entry_t > entries;
+  time_index index;
+  uint64_t sample;
+
+  for (uint64_t i = 0; i < NENTRIES; i++)
+    entries.push_back( entry( i * uint64_t(RATE), EPOCH + i, 0.25, 100e6 ) );
+
+  /* a line cut short by a crash is skipped */
+  std::string filename = write_index( entries, "12345 17" );
+  check( index.load( filename ), "failed to load " + filename );
+  std::remove( filename.c_str() );
+
+  check( index.entries().size() == NENTRIES, "unexpected number of entries" );
+
+  check( !index.lookup( EPOCH, 0.2, RATE, sample ), "found a time before the first entry" );
+
+  check( index.lookup( EPOCH, 0.25, RATE, sample ) && 0 == sample,
+         "the first entry isn't found" );
+
+  /* between entries the sample is extrapolated from the one before */
+  check( index.lookup( EPOCH + 1234, 0.75, RATE, sample ) &&
+         1234 * uint64_t(RATE) + uint64_t(RATE / 2) == sample,
+         "wrong sample between entries" );
+
+  /* past the last entry as well */
+  check( index.lookup( EPOCH + NENTRIES + 9, 0.25, RATE, sample ) &&
+         ( NENTRIES + 9 ) * uint64_t(RATE) == sample,
+         "wrong sample past the last entry" );
+
+  /* a linear scan takes seconds here, the binary search milliseconds */
+  uint64_t errors = 0;
+  auto begin = std::chrono::steady_clock::now();
+
+  for (uint64_t i = 0; i < NLOOKUPS; i++) {
+    uint64_t secs = ( i * 7919 ) % NENTRIES;
+
+    if ( !index.lookup( EPOCH + secs, 0.5, RATE, sample ) ||
+         sample != secs * uint64_t(RATE) + uint64_t(RATE / 4) )
+      errors++;
+  }
+
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+  check( 0 == errors, std::to_string( errors ) + " lookups returned the wrong sample" );
+  check( elapsed.count() < 1.0, std::to_string( NLOOKUPS ) + " lookups took " +
+                                std::to_string( elapsed.count() ) + " s" );
+}
+
+static void test_unordered()
+{
+  std::vector< time_index_entry_t > entries;
+  time_index index;
+  uint64_t sample;
+
+  /* the host clock stepped back by 10 s at sample 2e6 */
+  entries.push_back( entry( 0, EPOCH + 20, 0, 100e6 ) );
+  entries.push_back( entry( 1000000, EPOCH + 21, 0, 100e6 ) );
+  entries.push_back( entry( 2000000, EPOCH + 12, 0, 100e6 ) );
+
+  std::string filename = write_index( entries, "" );
+  index.load( filename );
+  std::remove( filename.c_str() );
+
+  check( index.lookup( EPOCH + 12, 0.5, RATE, sample ) && 2500000 == sample,
+         "wrong sample after the clock stepped back" );
+  check( index.lookup( EPOCH + 20, 0.5, RATE, sample ) && 500000 == sample,
+         "wrong sample before the clock stepped back" );
+}
+
+static void test_segments()
+{
+  std::vector< time_index_entry_t > entries;
+  time_index index;
+
+  entries.push_back( entry( 0, EPOCH, 0, 100e6 ) );
+  entries.push_back( entry( 1000000, EPOCH + 1, 0, 100e6 ) );
+  /* retune */
+  entries.push_back( entry( 1500000, EPOCH + 1, 0.5, 101e6 ) );
+  entries.push_back( entry( 2500000, EPOCH + 2, 0.5, 101e6 ) );
+  /* 3 s of dropped samples */
+  entries.push_back( entry( 3000000, EPOCH + 6, 0, 101e6 ) );
+  entries.push_back( entry( 4000000, EPOCH + 7, 0, 101e6 ) );
+
+  std::string filename = write_index( entries, "" );
+  index.load( filename );
+  std::remove( filename.c_str() );
+
+  std::vector< uint64_t > starts = index.segments( RATE );
+  check( 3 == starts.size() && 0 == starts[0] && 1500000 == starts[1] &&
+         3000000 == starts[2], "wrong segments" );
+
+  /* without the rate only the retune is visible */
+  starts = index.segments( 0 );
+  check( 2 == starts.size() && 0 == starts[0] && 1500000 == starts[1],
+         "wrong segments without a sample rate" );
+}
+
+int main()
+{
+  test_lookup();
+  test_unordered();
+  test_segments();
+
+  if ( failures ) {
+    std::cerr << failures << " failures" << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,259 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+#include <boost/format.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/json_parser.hpp>
+
+#include "sigmf.h"
+
+#define SIGMF_DATA_EXT ".sigmf-data"
+#define SIGMF_META_EXT ".sigmf-meta"
+
+static bool ends_with( const std::string &str, const std::string &suffix )
+{
+  return str.size() >= suffix.size() &&
+         0 == str.compare( str.size() - suffix.size(), suffix.size(), suffix );
+}
+
+std::string sigmf_meta_filename( const std::string &data_filename )
+{
+  if ( ends_with( data_filename, SIGMF_DATA_EXT ) )
+    return data_filename.substr( 0, data_filename.size() - strlen(SIGMF_DATA_EXT) ) +
+           SIGMF_META_EXT;
+
+  return data_filename + SIGMF_META_EXT;
+}
+
+std::string sigmf_data_filename( const std::string &meta_filename )
+{
+  if ( ends_with( meta_filename, SIGMF_META_EXT ) )
+    return meta_filename.substr( 0, meta_filename.size() - strlen(SIGMF_META_EXT) ) +
+           SIGMF_DATA_EXT;
+
+  return meta_filename;
+}
+
+std::string sigmf_datatype( iq_format_t format )
+{
+  switch ( format ) {
+  case IQ_FORMAT_CU8:  return "cu8";
+  case IQ_FORMAT_CS8:  return "ci8";
+  case IQ_FORMAT_CS16: return "ci16_le";
+  case IQ_FORMAT_CF32: return "cf32_le";
+  }
+  return "";
+}
+
+iq_format_t iq_format_from_sigmf( const std::string &datatype )
+{
+  if ( "cu8" == datatype )
+    return IQ_FORMAT_CU8;
+  if ( "ci8" == datatype )
+    return IQ_FORMAT_CS8;
+  if ( "ci16_le" == datatype )
+    return IQ_FORMAT_CS16;
+  if ( "cf32_le" == datatype )
+    return IQ_FORMAT_CF32;
+
+  throw std::runtime_error( "Unsupported SigMF datatype '" + datatype + "'." );
+}
+
+bool sigmf_read( const std::string &meta_filename, sigmf_meta_t &meta )
+{
+  std::ifstream file( meta_filename.c_str() );
+  if ( !file )
+    return false;
+
+  boost::property_tree::ptree root;
+
+  try {
+    boost::property_tree::read_json( file, root );
+
+    const boost::property_tree::ptree &global = root.get_child( "global" );
+    meta.format = iq_format_from_sigmf( global.get< std::string >( "core:datatype" ) );
+    meta.sample_rate = global.get< double >( "core:sample_rate", 0 );
+    meta.num_channels = global.get< size_t >( "core:num_channels", 1 );
+
+    /* the default has to outlive the loops, get_child() may return it */
+    const boost::property_tree::ptree none;
+
+    meta.captures.clear();
+    for ( auto &entry : root.get_child( "captures", none ) ) {
+      const boost::property_tree::ptree &capture = entry.second;
+
+      meta.captures.push_back( sigmf_capture_t(
+        capture.get< uint64_t >( "core:sample_start", 0 ),
+        capture.get< double >( "core:frequency", 0 ),
+        capture.get< std::string >( "core:datetime", "" ) ) );
+    }
+
+    meta.annotations.clear();
+    for ( auto &entry : root.get_child( "annotations", none ) ) {
+      sigmf_annotation_t annotation;
+
+      annotation.sample_start = entry.second.get< uint64_t >( "core:sample_start", 0 );
+      annotation.comment = entry.second.get< std::string >( "core:comment", "" );
+      meta.annotations.push_back( annotation );
+    }
+  } catch ( const boost::property_tree::ptree_error &e ) {
+    throw std::runtime_error( "Failed to parse " + meta_filename + ": " + e.what() );
+  }
+
+  return true;
+}
+
+static std::string json_string( const std::string &value )
+{
+  std::string out = "\"";
+
+  for ( char c : value ) {
+    if ( '"' == c || '\\' == c )
+      out += '\\';
+    if ( (unsigned char)c < 0x20 )
+      out += str( boost::format("\\u%04x") % int(c) );
+    else
+      out += c;
+  }
+
+  return out + "\"";
+}
+
+void sigmf_write( const std::string &meta_filename, const sigmf_meta_t &meta )
+{
+  /* write a temporary file and rename it, so readers never see half a file */
+  std::string tmp_filename = meta_filename + ".tmp";
+  std::ofstream file( tmp_filename.c_str() );
+  if ( !file )
+    throw std::runtime_error( "Failed to create " + tmp_filename );
+
+  file << "{\n"
+       << "    \"global\": {\n"
+       << "        \"core:datatype\": " << json_string( sigmf_datatype( meta.format ) ) << ",\n";
+  if ( meta.sample_rate > 0 )
+    file << boost::format("        \"core:sample_rate\": %.17g,\n") % meta.sample_rate;
+  if ( meta.num_channels > 1 )
+    file << boost::format("        \"core:num_channels\": %d,\n") % meta.num_channels;
+  file << "        \"core:recorder\": \"gr-osmosdr\",\n"
+       << "        \"core:version\": \"1.0.0\"\n"
+       << "    },\n";
+
+  std::vector< sigmf_capture_t > captures = meta.captures;
+  if ( captures.empty() )
+    captures.push_back( sigmf_capture_t() );
+
+  file << "    \"captures\": [";
+  for ( size_t i = 0; i < captures.size(); i++ ) {
+    const sigmf_capture_t &capture = captures[i];
+
+    file << (i ? "," : "") << "\n        {\n"
+         << "            \"core:sample_start\": " << capture.sample_start;
+    if ( capture.frequency > 0 )
+      file << boost::format(",\n            \"core:frequency\": %.17g") % capture.frequency;
+    if ( capture.datetime.length() )
+      file << ",\n            \"core:datetime\": " << json_string( capture.datetime );
+    file << "\n        }";
+  }
+  file << "\n    ],\n";
+
+  file << "    \"annotations\": [";
+  for ( size_t i = 0; i < meta.annotations.size(); i++ ) {
+    const sigmf_annotation_t &annotation = meta.annotations[i];
+
+    file << (i ? "," : "") << "\n        {\n"
+         << "            \"core:sample_start\": " << annotation.sample_start;
+    if ( annotation.comment.length() )
+      file << ",\n            \"core:comment\": " << json_string( annotation.comment );
+    file << "\n        }";
+  }
+  file << (meta.annotations.size() ? "\n    " : "") << "]\n"
+       << "}\n";
+
+  file.close();
+
+#ifdef _WIN32
+  /* rename() doesn't replace existing files on windows */
+  std::remove( meta_filename.c_str() );
+#endif
+
+  if ( !file || 0 != std::rename( tmp_filename.c_str(), meta_filename.c_str() ) )
+    throw std::runtime_error( "Failed to write " + meta_filename );
+}
+
+std::string sigmf_datetime( uint64_t secs, double frac_secs )
+{
+  time_t t = secs;
+  struct tm tm;
+
+#ifdef _WIN32
+  gmtime_s( &tm, &t );
+#else
+  gmtime_r( &t, &tm );
+#endif
+
+  char buf[32];
+  strftime( buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", &tm );
+
+  /* microseconds, without rounding into the next second */
+  long usecs = std::min( long(frac_secs * 1e6), 999999L );
+
+  return str( boost::format("%s.%06dZ") % buf % usecs );
+}
+
+bool sigmf_parse_datetime( const std::string &datetime,
+                           uint64_t &secs, double &frac_secs )
+{
+  struct tm tm;
+  double sec;
+
+  memset( &tm, 0, sizeof(tm) );
+
+  if ( 6 != sscanf( datetime.c_str(), "%d-%d-%dT%d:%d:%lf",
+                    &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                    &tm.tm_hour, &tm.tm_min, &sec ) )
+    return false;
+
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  tm.tm_sec = int( sec );
+
+#ifdef _WIN32
+  time_t t = _mkgmtime( &tm );
+#else
+  time_t t = timegm( &tm );
+#endif
+
+  if ( t < 0 )
+    return false;
+
+  secs = t;
+  frac_secs = sec - tm.tm_sec;
+
+  return true;
+}
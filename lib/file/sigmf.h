@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef SIGMF_H
+#define SIGMF_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "iq_format.h"
+
+/*
+ * Minimal SigMF (https://sigmf.org) metadata support: the global datatype
+ * and sample rate, capture segments and free form annotations.  Anything
+ * else in an existing .sigmf-meta file is ignored.
+ */
+
+struct sigmf_capture_t
+{
+  sigmf_capture_t( uint64_t start = 0, double freq = 0,
+                   const std::string &time = "" ) :
+    sample_start(start), frequency(freq), datetime(time)
+  {}
+
+  uint64_t sample_start;
+  double frequency;      /* 0 if unknown */
+  std::string datetime;  /* ISO 8601, empty if unknown */
+};
+
+struct sigmf_annotation_t
+{
+  uint64_t sample_start;
+  std::string comment;
+};
+
+struct sigmf_meta_t
+{
+  sigmf_meta_t() : format(IQ_FORMAT_CF32), sample_rate(0), num_channels(1) {}
+
+  iq_format_t format;
+  double sample_rate;    /* 0 if unknown */
+  size_t num_channels;   /* interleaved in the data file */
+  std::vector< sigmf_capture_t > captures;
+  std::vector< sigmf_annotation_t > annotations;
+};
+
+/* foo.sigmf-data <-> foo.sigmf-meta, other names get the suffix appended */
+std::string sigmf_meta_filename( const std::string &data_filename );
+std::string sigmf_data_filename( const std::string &meta_filename );
+
+/* SigMF datatype names: cu8, ci8, ci16_le, cf32_le */
+std::string sigmf_datatype( iq_format_t format );
+iq_format_t iq_format_from_sigmf( const std::string &datatype );
+
+/* returns false if the file doesn't exist, throws if it can't be parsed */
+bool sigmf_read( const std::string &meta_filename, sigmf_meta_t &meta );
+void sigmf_write( const std::string &meta_filename, const sigmf_meta_t &meta );
+
+/* formats a UHD style time (whole and fractional seconds) as ISO 8601 */
+std::string sigmf_datetime( uint64_t secs, double frac_secs );
+
+/* parses an ISO 8601 UTC time as written by sigmf_datetime() */
+bool sigmf_parse_datetime( const std::string &datetime,
+                           uint64_t &secs, double &frac_secs );
+
+#endif // SIGMF_H
@@ -0,0 +1,150 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cmath>
+
+#include <boost/format.hpp>
+
+#include "time_index.h"
+
+std::string time_index_filename( const std::string &data_filename )
+{
+  return data_filename + ".idx";
+}
+
+std::string time_index_line( const time_index_entry_t &entry )
+{
+  return str( boost::format("%d %d %.9f %.17g\n")
+              % entry.sample % entry.secs % entry.frac % entry.freq );
+}
+
+static bool entry_before( const time_index_entry_t &a, const time_index_entry_t &b )
+{
+  return a.secs < b.secs || ( a.secs == b.secs && a.frac < b.frac );
+}
+
+void time_index::sort()
+{
+  /* a host clock stepping backwards may leave entries out of order */
+  std::stable_sort( _entries.begin(), _entries.end(), entry_before );
+}
+
+bool time_index::load( const std::string &filename )
+{
+  std::ifstream file( filename.c_str() );
+  if ( !file )
+    return false;
+
+  _entries.clear();
+
+  std::string line;
+  while ( std::getline( file, line ) ) {
+    std::istringstream iss( line );
+    time_index_entry_t entry;
+
+    /* skips a line cut short by a crash */
+    if ( iss >> entry.sample >> entry.secs >> entry.frac >> entry.freq )
+      _entries.push_back( entry );
+  }
+
+  sort();
+
+  return true;
+}
+
+void time_index::load( const sigmf_meta_t &meta )
+{
+  _entries.clear();
+
+  for ( const sigmf_capture_t &capture : meta.captures ) {
+    time_index_entry_t entry;
+
+    if ( !sigmf_parse_datetime( capture.datetime, entry.secs, entry.frac ) )
+      continue;
+
+    entry.sample = capture.sample_start;
+    entry.freq = capture.frequency;
+    _entries.push_back( entry );
+  }
+
+  sort();
+}
+
+bool time_index::lookup( uint64_t secs, double frac, double rate,
+                         uint64_t &sample ) const
+{
+  time_index_entry_t key;
+  key.secs = secs;
+  key.frac = frac;
+
+  /* the last entry at or before the requested time */
+  auto it = std::upper_bound( _entries.begin(), _entries.end(), key, entry_before );
+  if ( it == _entries.begin() )
+    return false;
+  --it;
+
+  double delta = double( secs - it->secs ) + ( frac - it->frac );
+
+  sample = it->sample + ( rate > 0 ? uint64_t( std::llround( delta * rate ) ) : 0 );
+
+  return true;
+}
+
+static bool sample_before( const time_index_entry_t &a, const time_index_entry_t &b )
+{
+  return a.sample < b.sample;
+}
+
+std::vector< uint64_t > time_index::segments( double rate ) const
+{
+  std::vector< time_index_entry_t > entries = _entries;
+  std::vector< uint64_t > starts;
+
+  std::stable_sort( entries.begin(), entries.end(), sample_before );
+
+  for (size_t i = 0; i < entries.size(); i++) {
+    const time_index_entry_t &entry = entries[i];
+
+    if ( 0 == i ) {
+      starts.push_back( entry.sample );
+      continue;
+    }
+
+    const time_index_entry_t &prev = entries[i - 1];
+    bool gap = false;
+
+    if ( rate > 0 ) {
+      double expected = ( entry.sample - prev.sample ) / rate;
+      double delta = ( double(entry.secs) - double(prev.secs) ) + ( entry.frac - prev.frac );
+
+      gap = std::fabs( delta - expected ) > 1 / rate;
+    }
+
+    if ( ( gap || entry.freq != prev.freq ) && entry.sample != starts.back() )
+      starts.push_back( entry.sample );
+  }
+
+  return starts;
+}
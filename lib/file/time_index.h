@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef TIME_INDEX_H
+#define TIME_INDEX_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+#include "sigmf.h"
+
+/*
+ * Sidecar index mapping sample offsets to time and frequency, written by
+ * the file sink next to the data as <data>.idx.  Each line holds
+ *
+ *   <sample> <full secs> <frac secs> <center freq>
+ *
+ * with entries at the start, at every rx_time tag and retune, after
+ * dropped samples and once per second of samples.  The file is only ever
+ * appended to, so a crashed recording keeps its index.
+ */
+struct time_index_entry_t
+{
+  uint64_t sample;
+  uint64_t secs;
+  double frac;
+  double freq;
+};
+
+std::string time_index_filename( const std::string &data_filename );
+std::string time_index_line( const time_index_entry_t &entry );
+
+class time_index
+{
+public:
+  /* returns false if the file doesn't exist */
+  bool load( const std::string &filename );
+
+  /* builds the index from capture segments carrying a datetime */
+  void load( const sigmf_meta_t &meta );
+
+  bool empty() const { return _entries.empty(); }
+  const std::vector< time_index_entry_t > &entries() const { return _entries; }
+
+  /*
+   * Finds the sample recorded at the given time, extrapolating from the
+   * closest entry before it at the given sample rate.  O(log n).  Returns
+   * false if the time lies before the first entry.
+   */
+  bool lookup( uint64_t secs, double frac, double rate, uint64_t &sample ) const;
+
+  /*
+   * Returns the first sample of every capture segment, i.e. of every run
+   * of entries recorded at one frequency without a gap.  A gap is a time
+   * stamp more than one sample off from the previous entry extrapolated
+   * at the given sample rate, which isn't checked if the rate is unknown.
+   */
+  std::vector< uint64_t > segments( double rate ) const;
+
+private:
+  void sort();
+
+  std::vector< time_index_entry_t > _entries;
+};
+
+#endif // TIME_INDEX_H
@@ -33,6 +33,7 @@
 
 #define BUF_LEN  (16 * 32 * 512) /* must be multiple of 512 */
 #define BUF_NUM   15
+#define BUF_MIN    3 /* buffers queued before work() produces output */
 
 #define HACKRF_OC_PORT_COUNT 8
 #define HACKRF_OC_PORTS_PER_SIDE 4
@@ -31,6 +31,8 @@
 #include <stdexcept>
 #include <iostream>
 #include <chrono>
+#include <algorithm>
+#include <cmath>
 
 #include <gnuradio/io_signature.h>
 
@@ -38,6 +40,12 @@
 
 #include "arg_helpers.h"
 
+#define SWEEP_BLOCK_SAMPLES (16384 / BYTES_PER_SAMPLE) /* firmware sweep block */
+#define SWEEP_HEADER_SAMPLES (10 / BYTES_PER_SAMPLE) /* 0x7f 0x7f, 64 bit freq */
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t AGC_KEY = pmt::string_to_symbol("rx_agc");
+
 hackrf_source_c_sptr make_hackrf_source_c (const std::string & args)
 {
   return gnuradio::get_initial_sptr(new hackrf_source_c (args));
@@ -65,32 +73,56 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
     hackrf_common::hackrf_common(args),
+    _lut(false),
     _buf(NULL),
     _lna_gain(0),
-    _vga_gain(0)
+    _vga_gain(0),
+    _sweep(false),
+    _sweep_bytes(0),
+    _sweep_step(0),
+    _sweep_freq(0)
 {
   dict_t dict = params_to_dict(args);
 
+  _id = pmt::string_to_symbol(args);
+
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_queued = 0;
+  _buf_min = BUF_MIN;
+  _latency_stats = false;
 
   if (dict.count("buffers"))
     _buf_num = std::stoi(dict["buffers"]);
 
+  if (dict.count("minbuf"))
+    _buf_min = std::stoi(dict["minbuf"]);
+
+  if (dict.count("latency_stats"))
+    _latency_stats = (dict["latency_stats"] == "1");
+
 //  if (dict.count("buflen"))
 //    _buf_len = std::stoi(dict["buflen"]);
 
+  _decim = 1;
+  if (dict.count("decim"))
+    _decim = std::stoi(dict["decim"]);
+
+  if (!iq8_decimator::valid_decimation(_decim))
+    throw std::runtime_error("Unsupported decimation " + dict["decim"] + ".");
+
+  if (_decim > 1)
+    _decimator.reset( new iq8_decimator(_decim, false) );
+
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
   if (0 == _buf_len || _buf_len % 512 != 0) /* len must be multiple of 512 */
     _buf_len = BUF_LEN;
 
-  _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+  /* 1 lets work() drain a partially consumed buffer as soon as it is queued */
+  _buf_min = std::max(1u, std::min(_buf_min, _buf_num));
 
-  // create a lookup table for gr_complex values
-  for (unsigned int i = 0; i <= 0xff; i++) {
-    _lut.push_back( float(int8_t(i)) * (1.0f/128.0f) );
-  }
+  _samp_avail = _buf_len / BYTES_PER_SAMPLE;
 
   if ( BUF_NUM != _buf_num || BUF_LEN != _buf_len ) {
     std::cerr << "Using " << _buf_num << " buffers of size " << _buf_len << "."
@@ -118,6 +150,8 @@ hackrf_source_c::hackrf_source_c (const std::string &args)
     for(unsigned int i = 0; i < _buf_num; ++i)
       _buf[i] = (unsigned char *) malloc(_buf_len);
   }
+
+  _latency.resize(_buf_num);
 }
 
 /*
@@ -148,13 +182,19 @@ int hackrf_source_c::hackrf_rx_callback(unsigned char *buf, uint32_t len)
 
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _latency.stamp(buf_tail);
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
+      _samp_queued += len / BYTES_PER_SAMPLE; /* an overrun replaces samples */
     }
+
+    /* only wake work() once it has something to do */
+    if (_buf_used < _buf_min)
+      return 0;
   }
 
   _buf_cond.notify_one();
@@ -167,8 +207,35 @@ bool hackrf_source_c::start()
   if ( ! _dev.get() )
     return false;
 
+  {
+    std::lock_guard<std::mutex> lock(_buf_mutex);
+
+    _buf_head = _buf_used = _buf_offset = 0;
+    _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+    _samp_queued = 0;
+    _latency.reset();
+  }
+
+  if (_decimator)
+    _decimator->reset();
+  _dc.set_sample_rate( hackrf_common::get_sample_rate() );
+
   hackrf_common::start();
-  int ret = hackrf_start_rx( _dev.get(), _hackrf_rx_callback, (void *)this );
+
+  int ret;
+#ifdef HACKRF_SWEEP_SUPPORT
+  if ( _sweep ) {
+    _sweep_freq = 0;
+    ret = hackrf_init_sweep( _dev.get(), _sweep_ranges.data(), _sweep_ranges.size() / 2,
+                             _sweep_bytes, _sweep_step, 0, LINEAR );
+    if ( ret != HACKRF_SUCCESS ) {
+      std::cerr << "Failed to set up the sweep (" << ret << ")" << std::endl;
+      return false;
+    }
+    ret = hackrf_start_rx_sweep( _dev.get(), _hackrf_rx_callback, (void *)this );
+  } else
+#endif
+  ret = hackrf_start_rx( _dev.get(), _hackrf_rx_callback, (void *)this );
   if ( ret != HACKRF_SUCCESS ) {
     std::cerr << "Failed to start RX streaming (" << ret << ")" << std::endl;
     return false;
@@ -183,6 +250,16 @@ bool hackrf_source_c::stop()
 
   hackrf_common::stop();
   int ret = hackrf_stop_rx( _dev.get() );
+
+  /* wake up a work() waiting for buffers so it sees we stopped */
+  _buf_cond.notify_all();
+
+  if ( _latency_stats ) {
+    std::lock_guard<std::mutex> lock(_buf_mutex);
+    std::cerr << "hackrf_source_c: callback to work latency: "
+              << _latency.summary() << std::endl;
+  }
+
   if ( ret != HACKRF_SUCCESS ) {
     std::cerr << "Failed to stop RX streaming (" << ret << ")" << std::endl;
     return false;
@@ -204,8 +281,10 @@ int hackrf_source_c::work( int noutput_items,
   {
     std::unique_lock<std::mutex> lock(_buf_mutex);
 
-    while (_buf_used < 3 && running) { // collect at least 3 buffers
-      _buf_cond.wait_for( lock , std::chrono::milliseconds(100));
+    while (_buf_used < _buf_min && running) {
+      // The callback notifies once _buf_min buffers are queued and stop()
+      // wakes us up as well, the timeout only catches a vanished device.
+      _buf_cond.wait_for( lock , std::chrono::seconds(1));
 
       // Re-check whether the device has closed or stopped streaming
       if ( _dev.get() )
@@ -218,38 +297,82 @@ int hackrf_source_c::work( int noutput_items,
   if ( ! running )
     return WORK_DONE;
 
-  const uint8_t *buf = _buf[_buf_head] + _buf_offset * BYTES_PER_SAMPLE;
-#define TO_COMPLEX(p) gr_complex( _lut[(p)[0]], _lut[(p)[1]] )
-
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
-
-    _buf_offset += noutput_items;
-    _samp_avail -= noutput_items;
-  } else {
-    for (int i = 0; i < _samp_avail; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
-
-    {
-      std::lock_guard<std::mutex> lock(_buf_mutex);
+  std::complex<double> dc = _lut.update( _dc );
+  if (_decimator)
+    _decimator->set_dc_offset( dc );
+
+  float gain;
+  if ( _lut.update_gain( gain ) )
+    add_item_tag( 0, nitems_written(0), AGC_KEY, pmt::from_double( gain ), _id );
+
+  while (noutput_items && _buf_used) {
+    int nout = std::min(noutput_items, _samp_avail);
+    const uint8_t *buf = _buf[_buf_head] + _buf_offset * BYTES_PER_SAMPLE;
+    int nin = nout;
+
+    if (0 == _buf_offset)
+      _latency.consumed(_buf_head);
+
+    if (_sweep) {
+      unsigned int in_block = _buf_offset % SWEEP_BLOCK_SAMPLES;
+
+      if (0 == in_block) {
+        /* the hop frequency heads every block, tag where it changes */
+        if (0x7f == buf[0] && 0x7f == buf[1]) {
+          uint64_t freq = 0;
+          for (int i = 9; i >= 2; i--)
+            freq = (freq << 8) | buf[i];
+
+          if (freq != _sweep_freq) {
+            uint64_t offset = nitems_written(0) + (out - (gr_complex *)output_items[0]);
+            add_item_tag(0, offset, FREQ_KEY, pmt::from_double(freq), _id);
+            _sweep_freq = freq;
+          }
+        }
+
+        _samp_avail -= SWEEP_HEADER_SAMPLES;
+        _buf_offset += SWEEP_HEADER_SAMPLES;
+        continue;
+      }
+
+      nin = nout = std::min<int>(nout, SWEEP_BLOCK_SAMPLES - in_block);
+    }
 
-      _buf_head = (_buf_head + 1) % _buf_num;
-      _buf_used--;
+    if (_decimator) {
+      /* at most one output per _decim inputs, so this never overflows out */
+      nin = (int)std::min< size_t >( size_t(noutput_items) * _decim, _samp_avail );
+      size_t produced = _decimator->process( out, buf, nin );
+      out += produced;
+      noutput_items -= produced;
+    } else {
+      _lut.convert( out, buf, nout, _dc );
+      out += nout;
+      noutput_items -= nout;
     }
 
-    buf = _buf[_buf_head];
+    _samp_avail -= nin;
 
-    int remaining = noutput_items - _samp_avail;
+    if (!_samp_avail) {
+      {
+        std::lock_guard<std::mutex> lock(_buf_mutex);
 
-    for (int i = 0; i < remaining; ++i)
-      *out++ = TO_COMPLEX( buf + i*BYTES_PER_SAMPLE );
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
+      }
+      _samp_avail = _buf_len / BYTES_PER_SAMPLE;
+      _buf_offset = 0;
+    } else {
+      _buf_offset += nin;
+    }
+  }
 
-    _buf_offset = remaining;
-    _samp_avail = (_buf_len / BYTES_PER_SAMPLE) - remaining;
+  if (_decimator) {
+    size_t nin;
+    std::complex<double> sum = _decimator->take_input_sum( nin );
+    _dc.update( sum, nin );
   }
 
-  return noutput_items;
+  return (out - ((gr_complex *)output_items[0]));
 }
 
 std::vector<std::string> hackrf_source_c::get_devices()
@@ -264,17 +387,32 @@ size_t hackrf_source_c::get_num_channels()
 
 osmosdr::meta_range_t hackrf_source_c::get_sample_rates()
 {
-  return hackrf_common::get_sample_rates();
+  osmosdr::meta_range_t range = hackrf_common::get_sample_rates();
+
+  if (_decim > 1) {
+    osmosdr::meta_range_t decimated;
+
+    for (const osmosdr::range_t &r : range)
+      decimated.push_back( osmosdr::range_t( r.start() / _decim ) );
+
+    return decimated;
+  }
+
+  return range;
 }
 
 double hackrf_source_c::set_sample_rate( double rate )
 {
-  return hackrf_common::set_sample_rate(rate);
+  double device_rate = hackrf_common::set_sample_rate(rate * _decim);
+
+  _dc.set_sample_rate( device_rate );
+
+  return device_rate / _decim;
 }
 
 double hackrf_source_c::get_sample_rate()
 {
-  return hackrf_common::get_sample_rate();
+  return hackrf_common::get_sample_rate() / _decim;
 }
 
 osmosdr::freq_range_t hackrf_source_c::get_freq_range( size_t chan )
@@ -339,6 +477,17 @@ bool hackrf_source_c::get_gain_mode( size_t chan )
   return hackrf_common::get_gain_mode(chan);
 }
 
+bool hackrf_source_c::set_software_agc( agc_tracker *agc, size_t chan )
+{
+  if ( _decimator )
+    return false;
+
+  /* the conversion table measures and applies it in the integer domain */
+  _lut.set_agc( agc );
+
+  return true;
+}
+
 double hackrf_source_c::set_gain( double gain, size_t chan )
 {
   return hackrf_common::set_gain(gain, chan);
@@ -436,6 +585,16 @@ std::string hackrf_source_c::get_antenna( size_t chan )
   return hackrf_common::get_antenna(chan);
 }
 
+void hackrf_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _dc.set_mode( mode );
+}
+
+void hackrf_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _dc.set_offset( offset * 128.0 );
+}
+
 double hackrf_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
   return hackrf_common::set_bandwidth(bandwidth, chan);
@@ -450,3 +609,36 @@ osmosdr::freq_range_t hackrf_source_c::get_bandwidth_range( size_t chan )
 {
   return hackrf_common::get_bandwidth_range(chan);
 }
+
+uint64_t hackrf_source_c::get_capture_index( size_t chan )
+{
+  std::lock_guard<std::mutex> lock(_buf_mutex);
+
+  /* one more transfer may be filling up in the USB stack */
+  return (_samp_queued + _buf_len / BYTES_PER_SAMPLE) / _decim;
+}
+
+#ifdef HACKRF_SWEEP_SUPPORT
+bool hackrf_source_c::set_sweep( const std::vector< double > &freqs, size_t dwell )
+{
+  if ( freqs.size() < 2 || _decim > 1 || _buf_len % (SWEEP_BLOCK_SAMPLES * BYTES_PER_SAMPLE) )
+    return false;
+
+  /* the firmware starts on a whole MHz and steps by whole Hz */
+  double step = freqs[1] - freqs[0];
+  if ( std::fmod( freqs[0], 1e6 ) != 0 || std::floor( step ) != step ||
+       freqs.back() >= 65535e6 )
+    return false;
+
+  /* the first hop at or above the stop frequency is not visited */
+  _sweep_ranges = { uint16_t( freqs[0] / 1e6 ), uint16_t( freqs.back() / 1e6 + 1 ) };
+
+  size_t data = SWEEP_BLOCK_SAMPLES - SWEEP_HEADER_SAMPLES;
+  size_t blocks = std::max< size_t >( 1, (dwell + data - 1) / data );
+  _sweep_bytes = blocks * SWEEP_BLOCK_SAMPLES * BYTES_PER_SAMPLE;
+  _sweep_step = uint32_t( step );
+  _sweep = true;
+
+  return true;
+}
+#endif
@@ -24,11 +24,16 @@
 #include <gnuradio/sync_block.h>
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 
 #include <libhackrf/hackrf.h>
 
 #include "source_iface.h"
+#include "buffer_latency.h"
+#include "iq8_decimator.h"
+#include "iq8_lut.h"
+#include "dc_tracker.h"
 #include "hackrf_common.h"
 
 class hackrf_source_c;
@@ -103,6 +108,7 @@ public:
   osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
   bool set_gain_mode( bool automatic, size_t chan = 0 );
   bool get_gain_mode( size_t chan = 0 );
+  bool set_software_agc( agc_tracker *agc, size_t chan = 0 );
   double set_gain( double gain, size_t chan = 0 );
   double set_gain( double gain, const std::string & name, size_t chan = 0 );
   double get_gain( size_t chan = 0 );
@@ -115,29 +121,56 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  bool has_dc_offset_correction( size_t chan = 0 ) { return true; }
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
   double set_bandwidth( double bandwidth, size_t chan = 0 );
   double get_bandwidth( size_t chan = 0 );
   osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
 
+  uint64_t get_capture_index( size_t chan = 0 );
+
+#ifdef HACKRF_SWEEP_SUPPORT
+  bool set_sweep( const std::vector< double > &freqs, size_t dwell );
+#endif
+
 private:
   static int _hackrf_rx_callback(hackrf_transfer* transfer);
   int hackrf_rx_callback(unsigned char *buf, uint32_t len);
 
-  std::vector<float> _lut;
+  iq8_lut _lut;
+  dc_tracker _dc;
 
   unsigned char **_buf;
   unsigned int _buf_num;
   unsigned int _buf_len;
   unsigned int _buf_head;
   unsigned int _buf_used;
+  unsigned int _buf_min;
   std::mutex _buf_mutex;
   std::condition_variable _buf_cond;
 
   unsigned int _buf_offset;
   int _samp_avail;
+  uint64_t _samp_queued;
+
+  unsigned int _decim;
+  std::unique_ptr<iq8_decimator> _decimator;
+
+  buffer_latency _latency;
+  bool _latency_stats;
 
   double _lna_gain;
   double _vga_gain;
+
+  /* native sweep, blocks start with a header holding the hop frequency */
+  bool _sweep;
+  std::vector< uint16_t > _sweep_ranges;
+  uint32_t _sweep_bytes;
+  uint32_t _sweep_step;
+  uint64_t _sweep_freq;
+  pmt::pmt_t _id;
 };
 
 #endif /* INCLUDED_HACKRF_SOURCE_C_H */
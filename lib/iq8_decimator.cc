@@ -0,0 +1,275 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <volk/volk.h>
+
+#include "iq8_decimator.h"
+#include "iq8_lut.h"
+
+#define CIC_ORDER 4
+#define CIC_MAX_DECIM 64 /* 8 bit input + 4 * 6 bit growth fit 32 bit */
+
+#define FIR_TAPS_HALFBAND 63
+#define FIR_TAPS 31
+
+iq8_decimator::iq8_decimator( unsigned int decim, bool offset_binary ) :
+  _decim(decim),
+  _cic_decim(decim % 2 ? decim : decim / 2),
+  _fir_decim(decim % 2 ? 1 : 2),
+  _offset_binary(offset_binary)
+{
+  double gain = std::pow( double(_cic_decim), CIC_ORDER );
+
+  _scale = 1.0 / ( gain * 128.0 );
+
+  design_fir();
+  reset();
+  set_dc_offset( 0.0 );
+}
+
+bool iq8_decimator::valid_decimation( unsigned int decim )
+{
+  return decim >= 1 && ( decim % 2 ? decim : decim / 2 ) <= CIC_MAX_DECIM;
+}
+
+void iq8_decimator::reset()
+{
+  for (int s = 0; s < CIC_ORDER; s++)
+    for (int c = 0; c < 2; c++)
+      _integ[s][c] = _comb[s][c] = 0;
+
+  _cic_phase = 0;
+  _fir_phase = 0;
+  _delay_pos = 0;
+  _delay.assign( 2 * _taps.size(), gr_complex(0, 0) );
+
+  _sum_mark[0] = _sum_mark[1] = 0;
+  _sum_count = 0;
+}
+
+std::complex<double> iq8_decimator::take_input_sum( size_t &n )
+{
+  /* the integrator wraps, the difference does not as long as it fits */
+  int32_t sum[2];
+
+  for (int c = 0; c < 2; c++) {
+    sum[c] = int32_t( _integ[0][c] - _sum_mark[c] );
+    _sum_mark[c] = _integ[0][c];
+  }
+
+  n = _sum_count;
+  _sum_count = 0;
+
+  /* the integrators see cu8 relative to 127 */
+  double center = _offset_binary ? CU8_OFFSET - 127.0 : 0.0;
+
+  return std::complex<double>( sum[0] - n * center, sum[1] - n * center );
+}
+
+void iq8_decimator::set_dc_offset( const std::complex<double> &dc )
+{
+  float base = _offset_binary ? ( 127.0f - CU8_OFFSET ) / 128.0f : 0.0f;
+
+  _bias[0] = base - float( dc.real() ) / 128.0f;
+  _bias[1] = base - float( dc.imag() ) / 128.0f;
+}
+
+/*
+ * Frequency sampling design: the inverse of the CIC response up to the
+ * cutoff, integrated numerically and windowed.
+ */
+void iq8_decimator::design_fir()
+{
+  const size_t ntaps = 2 == _fir_decim ? FIR_TAPS_HALFBAND : FIR_TAPS;
+  const double cutoff = 2 == _fir_decim ? 0.5 * M_PI : 0.8 * M_PI;
+  const double mid = ( ntaps - 1 ) / 2.0;
+  const double r = _cic_decim;
+  const int grid = 512;
+  double sum = 0;
+
+  _taps.resize( ntaps );
+
+  for (size_t n = 0; n < ntaps; n++) {
+    double h = 0;
+
+    for (int k = 0; k <= grid; k++) {
+      double w = cutoff * k / grid;
+      double droop = k ? std::pow( std::sin( w / 2 ) / ( r * std::sin( w / ( 2 * r ) ) ),
+                                   CIC_ORDER )
+                       : 1.0;
+      double weight = ( 0 == k || grid == k ) ? 0.5 : 1.0;
+
+      h += weight * std::cos( w * ( n - mid ) ) / droop;
+    }
+
+    h *= cutoff / grid / M_PI;
+
+    /* Blackman window */
+    h *= 0.42 - 0.5 * std::cos( 2 * M_PI * n / ( ntaps - 1 ) )
+              + 0.08 * std::cos( 4 * M_PI * n / ( ntaps - 1 ) );
+
+    _taps[n] = h;
+    sum += h;
+  }
+
+  for (size_t n = 0; n < ntaps; n++)
+    _taps[n] /= sum;
+}
+
+void iq8_decimator::cic_output( uint32_t i, uint32_t q, gr_complex *&out )
+{
+  uint32_t x[2] = { i, q };
+
+  for (int s = 0; s < CIC_ORDER; s++) {
+    for (int c = 0; c < 2; c++) {
+      uint32_t y = x[c] - _comb[s][c];
+      _comb[s][c] = x[c];
+      x[c] = y;
+    }
+  }
+
+  gr_complex sample( int32_t(x[0]) * _scale + _bias[0], int32_t(x[1]) * _scale + _bias[1] );
+  size_t ntaps = _taps.size();
+
+  _delay[_delay_pos] = _delay[_delay_pos + ntaps] = sample;
+  _delay_pos = ( _delay_pos + 1 ) % ntaps;
+
+  if ( ++_fir_phase == _fir_decim ) {
+    _fir_phase = 0;
+    volk_32fc_32f_dot_prod_32fc( out++, &_delay[_delay_pos], _taps.data(), ntaps );
+  }
+}
+
+void iq8_decimator::integrate_default( const uint8_t *in, size_t nin, gr_complex *&out )
+{
+  for (size_t i = 0; i < nin; i++) {
+    uint32_t x[2];
+
+    for (int c = 0; c < 2; c++)
+      x[c] = _offset_binary ? uint32_t( int( in[i*2 + c] ) - 127 )
+                            : uint32_t( int( int8_t( in[i*2 + c] ) ) );
+
+    for (int s = 0; s < CIC_ORDER; s++) {
+      for (int c = 0; c < 2; c++) {
+        _integ[s][c] += x[c];
+        x[c] = _integ[s][c];
+      }
+    }
+
+    if ( ++_cic_phase == _cic_decim ) {
+      _cic_phase = 0;
+      cic_output( x[0], x[1], out );
+    }
+  }
+}
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+/*
+ * Each register holds two I/Q pairs as 32 bit lanes.  An integrator is a
+ * running sum, so adding the register shifted by one pair plus the last
+ * pair of the previous register, broadcast, integrates both at once.
+ * nin must be a multiple of 8.
+ */
+void iq8_decimator::integrate_sse2( const uint8_t *in, size_t nin, gr_complex *&out )
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset = _mm_set1_epi16( 127 );
+  __m128i carry[CIC_ORDER];
+  alignas(16) uint32_t tmp[16];
+
+  for (int s = 0; s < CIC_ORDER; s++)
+    carry[s] = _mm_set_epi32( _integ[s][1], _integ[s][0], _integ[s][1], _integ[s][0] );
+
+  for (size_t i = 0; i < nin; i += 8) {
+    __m128i bytes = _mm_loadu_si128( (const __m128i *)&in[i*2] );
+    __m128i lo, hi;
+
+    if ( _offset_binary ) {
+      lo = _mm_sub_epi16( _mm_unpacklo_epi8( bytes, zero ), offset );
+      hi = _mm_sub_epi16( _mm_unpackhi_epi8( bytes, zero ), offset );
+    } else {
+      /* sign extend by placing each byte in the upper half */
+      lo = _mm_srai_epi16( _mm_unpacklo_epi8( bytes, bytes ), 8 );
+      hi = _mm_srai_epi16( _mm_unpackhi_epi8( bytes, bytes ), 8 );
+    }
+
+    __m128i v[4] = {
+      _mm_srai_epi32( _mm_unpacklo_epi16( lo, lo ), 16 ),
+      _mm_srai_epi32( _mm_unpackhi_epi16( lo, lo ), 16 ),
+      _mm_srai_epi32( _mm_unpacklo_epi16( hi, hi ), 16 ),
+      _mm_srai_epi32( _mm_unpackhi_epi16( hi, hi ), 16 )
+    };
+
+    for (int k = 0; k < 4; k++) {
+      __m128i x = v[k];
+
+      for (int s = 0; s < CIC_ORDER; s++) {
+        x = _mm_add_epi32( x, _mm_slli_si128( x, 8 ) );
+        x = _mm_add_epi32( x, carry[s] );
+        carry[s] = _mm_shuffle_epi32( x, _MM_SHUFFLE(3, 2, 3, 2) );
+      }
+
+      _mm_store_si128( (__m128i *)&tmp[k*4], x );
+    }
+
+    for (int j = 0; j < 8; j++) {
+      if ( ++_cic_phase == _cic_decim ) {
+        _cic_phase = 0;
+        cic_output( tmp[j*2], tmp[j*2 + 1], out );
+      }
+    }
+  }
+
+  for (int s = 0; s < CIC_ORDER; s++) {
+    _mm_store_si128( (__m128i *)tmp, carry[s] );
+    _integ[s][0] = tmp[0];
+    _integ[s][1] = tmp[1];
+  }
+}
+#endif
+
+size_t iq8_decimator::process( gr_complex *out, const uint8_t *in, size_t nin )
+{
+  gr_complex *start = out;
+
+  _sum_count += nin;
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  size_t nsse = nin / 8 * 8;
+
+  integrate_sse2( in, nsse, out );
+  in += nsse * 2;
+  nin -= nsse;
+#endif
+
+  integrate_default( in, nin, out );
+
+  return out - start;
+}
@@ -0,0 +1,104 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_IQ8_DECIMATOR_H
+#define INCLUDED_IQ8_DECIMATOR_H
+
+#include <gnuradio/gr_complex.h>
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Decimator for the 8 bit I/Q delivered by rtl-sdr and HackRF.  It runs
+ * on the raw device buffers in the integer domain, so only the decimated
+ * stream is converted to gr_complex.
+ *
+ * A 4th order CIC decimates by decim / 2, or by decim if that is odd,
+ * using wrapping 32 bit integrators computed as SSE2 prefix sums over the
+ * interleaved I/Q pairs.  A float FIR then compensates the CIC droop and,
+ * for even factors, performs the last decimation by 2 with a sharp
+ * cutoff, leaving about 80% of the output bandwidth usable.
+ *
+ * The first integrator is the running sum of the input, so the sums a
+ * DC offset estimate needs come for free, and the offset is removed with
+ * the bias that is added anyway when the CIC output is converted.
+ */
+class iq8_decimator
+{
+public:
+  /* offset_binary selects cu8 as from rtl-sdr, otherwise cs8 as from HackRF */
+  iq8_decimator( unsigned int decim, bool offset_binary );
+
+  static bool valid_decimation( unsigned int decim );
+
+  unsigned int decimation() const { return _decim; }
+
+  /*
+   * Decimates nin samples and returns the number of outputs, which is at
+   * most (nin + decim - 1) / decim.
+   */
+  size_t process( gr_complex *out, const uint8_t *in, size_t nin );
+
+  /* forget the history, e.g. after a gap in the stream */
+  void reset();
+
+  /*
+   * Sum of the inputs relative to their mid-scale since the last call, n
+   * is set to their number.  Must be called at least every 2^24 inputs.
+   */
+  std::complex<double> take_input_sum( size_t &n );
+
+  /* DC offset in input units, 128 being full scale, removed from the output */
+  void set_dc_offset( const std::complex<double> &dc );
+
+private:
+  void integrate_default( const uint8_t *in, size_t nin, gr_complex *&out );
+#if defined(USE_SSE2) || defined(USE_AVX)
+  void integrate_sse2( const uint8_t *in, size_t nin, gr_complex *&out );
+#endif
+  void cic_output( uint32_t i, uint32_t q, gr_complex *&out );
+  void design_fir();
+
+  unsigned int _decim;
+  unsigned int _cic_decim;
+  unsigned int _fir_decim;
+  bool _offset_binary;
+
+  /* CIC state, wrapping arithmetic, [stage][I/Q] */
+  uint32_t _integ[4][2];
+  uint32_t _comb[4][2];
+  unsigned int _cic_phase;
+  float _scale;
+  float _bias[2];
+
+  uint32_t _sum_mark[2];
+  size_t _sum_count;
+
+  /* compensation FIR, the delay line is stored twice to avoid wrapping */
+  std::vector< float > _taps;
+  std::vector< gr_complex > _delay;
+  size_t _delay_pos;
+  unsigned int _fir_phase;
+};
+
+#endif /* INCLUDED_IQ8_DECIMATOR_H */
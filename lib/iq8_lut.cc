@@ -0,0 +1,124 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <cmath>
+
+#include "iq8_lut.h"
+
+/* finer changes of the estimate are not worth rebuilding the table */
+#define DC_STEP ( 1.0 / 256 )
+
+iq8_lut::iq8_lut( bool offset_binary ) :
+  _offset_binary(offset_binary),
+  _dc(0, 0),
+  _agc(NULL),
+  _gain(1.0f),
+  _lut(512)
+{
+  build();
+}
+
+void iq8_lut::build()
+{
+  const float center = _offset_binary ? CU8_OFFSET : 0.0f;
+  const float scale = _gain / 128.0f;
+
+  for (int i = 0; i < 256; i++) {
+    float x = _offset_binary ? float(i) : float(int8_t(i));
+
+    _lut[i] = ( x - center - float(_dc.real()) ) * scale;
+    _lut[256 + i] = ( x - center - float(_dc.imag()) ) * scale;
+  }
+}
+
+std::complex<double> iq8_lut::update( dc_tracker &dc )
+{
+  std::complex<double> offset = dc.enabled() ? dc.offset() : 0.0;
+
+  if ( std::abs( offset - _dc ) > DC_STEP ||
+       ( 0.0 == offset && 0.0 != _dc ) ) {
+    _dc = offset;
+    build();
+  }
+
+  return _dc;
+}
+
+bool iq8_lut::update_gain( float &gain )
+{
+  gain = _agc ? _agc->gain() : 1.0f;
+
+  if ( gain == _gain )
+    return false;
+
+  _gain = gain;
+  build();
+
+  return true;
+}
+
+void iq8_lut::convert( gr_complex *out, const uint8_t *in, size_t n, dc_tracker &dc )
+{
+  const float *lut_i = &_lut[0];
+  const float *lut_q = &_lut[256];
+
+  const bool agc = _agc && _agc->enabled();
+
+  if ( ! dc.tracking() && ! agc ) {
+    for (size_t i = 0; i < n; i++)
+      out[i] = gr_complex( lut_i[in[i*2]], lut_q[in[i*2 + 1]] );
+    return;
+  }
+
+  int64_t sum_i = 0, sum_q = 0;
+  uint64_t sq = 0;
+
+  if ( _offset_binary ) {
+    for (size_t i = 0; i < n; i++) {
+      int32_t x = in[i*2], y = in[i*2 + 1];
+      sum_i += x;
+      sum_q += y;
+      sq += x * x + y * y;
+      out[i] = gr_complex( lut_i[x], lut_q[y] );
+    }
+  } else {
+    for (size_t i = 0; i < n; i++) {
+      int32_t x = int8_t(in[i*2]), y = int8_t(in[i*2 + 1]);
+      sum_i += x;
+      sum_q += y;
+      sq += x * x + y * y;
+      out[i] = gr_complex( lut_i[uint8_t(x)], lut_q[uint8_t(y)] );
+    }
+  }
+
+  const double center = _offset_binary ? CU8_OFFSET : 0.0;
+
+  dc.update( std::complex<double>( sum_i - n * center, sum_q - n * center ), n );
+
+  if ( agc ) {
+    /* sum of squares around the level the table removes, in full scale */
+    double mi = center + _dc.real(), mq = center + _dc.imag();
+    double power = double(sq) - 2 * ( mi * sum_i + mq * sum_q ) + n * ( mi * mi + mq * mq );
+
+    _agc->update( power / ( 128.0 * 128.0 ), n );
+  }
+}
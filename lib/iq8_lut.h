@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_IQ8_LUT_H
+#define INCLUDED_IQ8_LUT_H
+
+#include <gnuradio/gr_complex.h>
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "dc_tracker.h"
+#include "agc_tracker.h"
+
+/* mid-scale of the offset binary samples of rtl-sdr */
+#define CU8_OFFSET 127.4f
+
+/*
+ * Lookup table conversion of 8 bit I/Q to gr_complex with the software
+ * DC offset correction folded into the table, so the offset is removed
+ * in the integer domain at no cost per sample.  The raw sums that feed
+ * the estimate are accumulated during the conversion.  Offsets are in
+ * input units, 128 being full scale.  The gain of a software AGC is
+ * folded in the same way, its power is measured from integer sums of
+ * squares.
+ */
+class iq8_lut
+{
+public:
+  /* offset_binary selects cu8 as from rtl-sdr, otherwise cs8 as from HackRF */
+  iq8_lut( bool offset_binary );
+
+  /*
+   * Rebuild the table if the estimate of dc moved, called once per work
+   * call.  Returns the offset the table now removes.
+   */
+  std::complex<double> update( dc_tracker &dc );
+
+  /* run the AGC on the raw samples, it stays owned by the caller */
+  void set_agc( agc_tracker *agc ) { _agc = agc; }
+
+  /*
+   * Rebuild the table if the AGC gain changed, called once per work call.
+   * Returns true with the new linear factor in gain if it did.
+   */
+  bool update_gain( float &gain );
+
+  /* convert n interleaved I/Q pairs, feeding their sums to dc and the AGC */
+  void convert( gr_complex *out, const uint8_t *in, size_t n, dc_tracker &dc );
+
+  gr_complex operator()( const uint8_t *in ) const
+  {
+    return gr_complex( _lut[in[0]], _lut[256 + in[1]] );
+  }
+
+private:
+  void build();
+
+  bool _offset_binary;
+  std::complex<double> _dc;
+  agc_tracker *_agc;
+  float _gain;
+  std::vector< float > _lut;
+};
+
+#endif /* INCLUDED_IQ8_LUT_H */
@@ -0,0 +1,175 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_IQ_BALANCE_TRACKER_H
+#define INCLUDED_IQ_BALANCE_TRACKER_H
+
+#include <osmosdr/source.h>
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <mutex>
+
+/*
+ * Blind IQ imbalance estimate for sources whose device cannot correct it.
+ *
+ * The imbalance is modelled as a gain g and a phase error phi of Q against
+ * I, which the correction Q' = a Q + b I with a = 1 / (g cos phi) and
+ * b = -tan phi removes.  Both follow from the second moments of the
+ * signal: g^2 = E[Q^2] / E[I^2] and sin phi = E[IQ] / sqrt(E[I^2] E[Q^2]).
+ *
+ * To bound the cost, the moments are only gathered on a window of
+ * STATS_LEN samples every 20 ms of stream and averaged over about half a
+ * second, independent of the sample rate.  The balance is reported as
+ * ( g - 1, phi ) with phi in radians.
+ */
+class iq_balance_tracker
+{
+public:
+  enum { STATS_LEN = 1024 };
+
+  iq_balance_tracker() :
+    _mode( osmosdr::source::IQBalanceOff ),
+    _period( 1e5 / 50 ), /* until the rate is known */
+    _skip( 0 ),
+    _primed( false ),
+    _balance( 0, 0 )
+  {
+    for ( double &m : _moments )
+      m = 0;
+  }
+
+  /* Off bypasses the correction, Manual holds it, Automatic tracks it */
+  void set_mode( int mode )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::IQBalanceAutomatic == mode &&
+         osmosdr::source::IQBalanceAutomatic != _mode ) {
+      _primed = false;
+      _skip = 0;
+    }
+
+    _mode = mode;
+  }
+
+  void set_balance( const std::complex<double> &balance )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    _balance = balance;
+  }
+
+  std::complex<double> balance()
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    return _balance;
+  }
+
+  void set_sample_rate( double rate )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( rate > 0 )
+      _period = std::max( size_t( rate / 50 ), size_t( STATS_LEN ) );
+  }
+
+  /* the correction to apply, false if it is bypassed */
+  bool correction( float &a, float &b )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::IQBalanceOff == _mode )
+      return false;
+
+    double g = 1.0 + _balance.real();
+    double phi = _balance.imag();
+
+    if ( g <= 0 || std::abs( phi ) >= M_PI / 2 )
+      return false;
+
+    a = 1.0 / ( g * std::cos( phi ) );
+    b = -std::tan( phi );
+
+    return true;
+  }
+
+  /* number of samples at the start of the next n to gather moments on */
+  size_t stats_len( size_t n )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::IQBalanceAutomatic != _mode )
+      return 0;
+
+    if ( _skip >= n ) {
+      _skip -= n;
+      return 0;
+    }
+
+    _skip = _period;
+
+    return std::min( n, size_t( STATS_LEN ) );
+  }
+
+  /* sums of I, Q, I^2, Q^2 and IQ over the n samples of a window */
+  void update( const double sums[5], size_t n )
+  {
+    std::lock_guard<std::mutex> lock( _mutex );
+
+    if ( osmosdr::source::IQBalanceAutomatic != _mode || 0 == n )
+      return;
+
+    /* central moments, the signal may still carry a DC offset */
+    double mi = sums[0] / n, mq = sums[1] / n;
+    double m[3] = { sums[2] / n - mi * mi,
+                    sums[3] / n - mq * mq,
+                    sums[4] / n - mi * mq };
+
+    double w = _primed ? 1.0 - std::exp( -1.0 / 25 ) : 1.0;
+
+    for ( int k = 0; k < 3; k++ )
+      _moments[k] += w * ( m[k] - _moments[k] );
+
+    _primed = true;
+
+    if ( _moments[0] <= 0 || _moments[1] <= 0 )
+      return;
+
+    double g = std::sqrt( _moments[1] / _moments[0] );
+    double s = _moments[2] / std::sqrt( _moments[0] * _moments[1] );
+
+    _balance = std::complex<double>( g - 1.0, std::asin( std::max( -0.99, std::min( 0.99, s ) ) ) );
+  }
+
+private:
+  std::mutex _mutex;
+  int _mode;
+  size_t _period;
+  size_t _skip;
+  bool _primed;
+  double _moments[3];
+  std::complex<double> _balance;
+};
+
+#endif /* INCLUDED_IQ_BALANCE_TRACKER_H */
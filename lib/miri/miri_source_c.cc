@@ -36,6 +36,7 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 
 #include <mirisdr.h>
@@ -46,6 +47,7 @@ using namespace boost::assign;
 
 #define BUF_SIZE  2304 * 8 * 2
 #define BUF_NUM   15
+#define BUF_MIN    3 // buffers queued before work() produces output
 #define BUF_SKIP  1 // buffers to skip due to garbage
 
 #define BYTES_PER_SAMPLE  4 // mirisdr device delivers 16 bit signed IQ data
@@ -95,14 +97,27 @@ miri_source_c::miri_source_c (const std::string &args)
     dev_index = boost::lexical_cast< unsigned int >( dict["miri"] );
 
   _buf_num = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_queued = 0;
   _samp_avail = BUF_SIZE / BYTES_PER_SAMPLE;
 
+  _buf_min = BUF_MIN;
+  _latency_stats = false;
+
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
 
+  if (dict.count("minbuf"))
+    _buf_min = boost::lexical_cast< unsigned int >( dict["minbuf"] );
+
+  if (dict.count("latency_stats"))
+    _latency_stats = boost::lexical_cast< bool >( dict["latency_stats"] );
+
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
+  /* 1 lets work() drain a partially consumed buffer as soon as it is queued */
+  _buf_min = std::max(1u, std::min(_buf_min, _buf_num));
+
   if ( BUF_NUM != _buf_num ) {
     std::cerr << "Using " << _buf_num << " buffers of size " << BUF_SIZE << "."
               << std::endl;
@@ -140,6 +155,8 @@ miri_source_c::miri_source_c (const std::string &args)
       _buf[i] = (unsigned short *) malloc(BUF_SIZE);
   }
 
+  _latency.resize(_buf_num);
+
   _thread = gr::thread::thread(_mirisdr_wait, this);
 }
 
@@ -156,6 +173,10 @@ miri_source_c::~miri_source_c ()
     _dev = NULL;
   }
 
+  if (_latency_stats)
+    std::cerr << "miri_source_c: callback to work latency: "
+              << _latency.summary() << std::endl;
+
   if (_buf) {
     for(unsigned int i = 0; i < _buf_num; ++i) {
       free(_buf[i]);
@@ -190,13 +211,19 @@ void miri_source_c::mirisdr_callback(unsigned char *buf, uint32_t len)
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
     _buf_lens[buf_tail] = len;
+    _latency.stamp(buf_tail);
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
+      _samp_queued += len / BYTES_PER_SAMPLE; /* an overrun replaces samples */
     }
+
+    /* only wake work() once it has something to do */
+    if (_buf_used < _buf_min)
+      return;
   }
 
   _buf_cond.notify_one();
@@ -228,47 +255,43 @@ int miri_source_c::work( int noutput_items,
   {
     std::unique_lock<std::mutex> lock( _buf_mutex );
 
-    while (_buf_used < 3 && _running) // collect at least 3 buffers
+    while (_buf_used < _buf_min && _running)
       _buf_cond.wait( lock );
   }
 
   if (!_running)
     return WORK_DONE;
 
-  short *buf = (short *)_buf[_buf_head] + _buf_offset;
+  while (noutput_items && _buf_used) {
+    if (0 == _buf_offset) {
+      _samp_avail = _buf_lens[_buf_head] / BYTES_PER_SAMPLE;
+      _latency.consumed(_buf_head);
+    }
 
-  if (noutput_items <= _samp_avail) {
-    for (int i = 0; i < noutput_items; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
+    const int nout = std::min(noutput_items, _samp_avail);
+    const short *buf = (short *)_buf[_buf_head] + _buf_offset;
 
-    _buf_offset += noutput_items * 2;
-    _samp_avail -= noutput_items;
-  } else {
-    for (int i = 0; i < _samp_avail; i++)
+    for (int i = 0; i < nout; i++)
       *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
                            float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
 
-    {
-      std::lock_guard<std::mutex> lock( _buf_mutex );
+    noutput_items -= nout;
+    _samp_avail -= nout;
 
-      _buf_head = (_buf_head + 1) % _buf_num;
-      _buf_used--;
-    }
+    if (!_samp_avail) {
+      {
+        std::lock_guard<std::mutex> lock( _buf_mutex );
 
-    buf = (short *)_buf[_buf_head];
-
-    int remaining = noutput_items - _samp_avail;
-
-    for (int i = 0; i < remaining; i++)
-      *out++ = gr_complex( float(*(buf + i * 2 + 0)) * (1.0f/4096.0f),
-                           float(*(buf + i * 2 + 1)) * (1.0f/4096.0f) );
-
-    _buf_offset = remaining * 2;
-    _samp_avail = (_buf_lens[_buf_head] / BYTES_PER_SAMPLE) - remaining;
+        _buf_head = (_buf_head + 1) % _buf_num;
+        _buf_used--;
+      }
+      _buf_offset = 0;
+    } else {
+      _buf_offset += nout * 2;
+    }
   }
 
-  return noutput_items;
+  return (out - ((gr_complex *)output_items[0]));
 }
 
 std::vector<std::string> miri_source_c::get_devices()
@@ -449,3 +472,11 @@ std::string miri_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+uint64_t miri_source_c::get_capture_index( size_t chan )
+{
+  std::lock_guard<std::mutex> lock( _buf_mutex );
+
+  /* one more transfer may be filling up in the USB stack */
+  return _samp_queued + BUF_SIZE / BYTES_PER_SAMPLE;
+}
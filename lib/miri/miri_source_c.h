@@ -28,6 +28,7 @@
 #include <condition_variable>
 
 #include "source_iface.h"
+#include "buffer_latency.h"
 
 class miri_source_c;
 typedef struct mirisdr_dev mirisdr_dev_t;
@@ -97,6 +98,8 @@ private:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  uint64_t get_capture_index( size_t chan = 0 );
+
 private:
   static void _mirisdr_callback(unsigned char *buf, uint32_t len, void *ctx);
   void mirisdr_callback(unsigned char *buf, uint32_t len);
@@ -110,12 +113,17 @@ private:
   unsigned int _buf_num;
   unsigned int _buf_head;
   unsigned int _buf_used;
+  unsigned int _buf_min;
   std::mutex _buf_mutex;
   std::condition_variable _buf_cond;
   bool _running;
 
   unsigned int _buf_offset;
   int _samp_avail;
+  uint64_t _samp_queued;
+
+  buffer_latency _latency;
+  bool _latency_stats;
 
   bool _auto_gain;
   unsigned int _skipped;
@@ -0,0 +1,239 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/filter/firdes.h>
+
+#include "resampler_c.h"
+
+#define RESAMPLER_FILTERS 32
+#define RESAMPLER_PASSBAND 0.8 /* of the lower nyquist rate */
+#define RESAMPLER_ATTENUATION 80
+#define RESAMPLER_MAX_DECIMATION 64
+
+/* below this the device rate is delivered as is */
+#define RATE_TOLERANCE 1e-6
+
+static const pmt::pmt_t RATE_KEY = pmt::string_to_symbol("rx_rate");
+
+resampler_c_sptr make_resampler_c( size_t nchan )
+{
+  return gnuradio::get_initial_sptr( new resampler_c( nchan ) );
+}
+
+resampler_c::resampler_c( size_t nchan )
+  : gr::block( "resampler_c",
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ),
+               gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ) ),
+    _nchan( nchan ),
+    _bypass( true ),
+    _updated( false ),
+    _input_rate( 0 ),
+    _output_rate( 0 ),
+    _ratio( 1 ),
+    _slack( 0 ),
+    _reanchor( true ),
+    _in_anchor( 0 ),
+    _out_anchor( 0 )
+{
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+double resampler_c::hardware_rate( const osmosdr::meta_range_t &rates, double rate )
+{
+  double best = 0;
+
+  for (const osmosdr::range_t &range : rates) {
+    if ( range.stop() < rate )
+      continue;
+
+    double candidate = range.start();
+
+    if ( rate > range.start() ) {
+      candidate = rate;
+      if ( range.step() > 0 )
+        candidate = range.start() + range.step() *
+                    std::ceil( (rate - range.start()) / range.step() - RATE_TOLERANCE );
+    }
+
+    if ( 0 == best || candidate < best )
+      best = candidate;
+  }
+
+  if ( 0 == best && ! rates.empty() )
+    best = rates.stop();
+
+  return best;
+}
+
+osmosdr::meta_range_t resampler_c::output_rates( const osmosdr::meta_range_t &rates )
+{
+  if ( rates.empty() )
+    return rates;
+
+  return osmosdr::meta_range_t( rates.start() / RESAMPLER_MAX_DECIMATION, rates.stop() );
+}
+
+double resampler_c::set_rates( double input_rate, double output_rate )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  _input_rate = input_rate;
+  _kernels.clear();
+
+  _bypass = input_rate <= 0 || output_rate <= 0 ||
+            std::abs( output_rate / input_rate - 1 ) < RATE_TOLERANCE;
+
+  if ( _bypass ) {
+    _ratio = 1;
+    _slack = 0;
+    set_history( 1 );
+  } else {
+    double ratio = std::max( output_rate / input_rate, 1.0 / RESAMPLER_MAX_DECIMATION );
+    double halfband = 0.5 * std::min( ratio, 1.0 );
+    double bw = RESAMPLER_PASSBAND * halfband;
+    double tb = RESAMPLER_PASSBAND / 2 * halfband;
+
+    /* designed at the rate of the filterbank, RESAMPLER_FILTERS times the input */
+    std::vector<float> taps =
+        gr::filter::firdes::low_pass_2( RESAMPLER_FILTERS, RESAMPLER_FILTERS,
+                                        bw + tb / 2, tb, RESAMPLER_ATTENUATION,
+                                        gr::fft::window::WIN_BLACKMAN_hARRIS );
+
+    for (size_t i = 0; i < _nchan; i++)
+      _kernels.emplace_back( new gr::filter::kernel::pfb_arb_resampler_ccf(
+                               float(ratio), taps, RESAMPLER_FILTERS ) );
+
+    /* the kernel rounds the ratio, report what it actually does */
+    const gr::filter::kernel::pfb_arb_resampler_ccf &kernel = *_kernels[0];
+    _ratio = kernel.interpolation_rate() /
+             ( kernel.decimation_rate() + double( kernel.fractional_rate() ) );
+
+    /* the kernel may step this far past the inputs it was given */
+    _slack = int( std::ceil( 1 / _ratio ) ) + 1;
+
+    set_history( kernel.taps_per_filter() );
+  }
+
+  _output_rate = input_rate * _ratio;
+  set_relative_rate( _ratio );
+
+  _updated = true;
+  _reanchor = true;
+
+  return _output_rate;
+}
+
+double resampler_c::get_sample_rate( void )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  return _output_rate;
+}
+
+void resampler_c::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  int required = _bypass ? noutput_items
+                         : int( std::ceil( noutput_items / _ratio ) ) + history() - 1 + _slack;
+
+  for (size_t i = 0; i < ninput_items_required.size(); i++)
+    ninput_items_required[i] = required;
+}
+
+/* must be called with _mutex held */
+void resampler_c::propagate_tags( int nread, int nwritten )
+{
+  const uint64_t start = nitems_read(0);
+  std::vector< gr::tag_t > tags;
+
+  for (size_t chan = 0; chan < _nchan; chan++) {
+    const uint64_t first = nitems_written( chan );
+    const uint64_t last = first + std::max( nwritten, 1 ) - 1;
+
+    get_tags_in_range( tags, chan, start, start + nread );
+
+    for (gr::tag_t tag : tags) {
+      uint64_t offset = _out_anchor +
+                        uint64_t( std::llround( (tag.offset - _in_anchor) * _ratio ) );
+
+      tag.offset = std::min( std::max( offset, first ), last );
+
+      if ( pmt::eq( tag.key, RATE_KEY ) )
+        tag.value = pmt::from_double( _output_rate );
+
+      add_item_tag( chan, tag );
+    }
+  }
+}
+
+int resampler_c::general_work( int noutput_items,
+                               gr_vector_int &ninput_items,
+                               gr_vector_const_void_star &input_items,
+                               gr_vector_void_star &output_items )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( _updated ) {
+    /* let the scheduler apply the new history first */
+    _updated = false;
+    return 0;
+  }
+
+  if ( _reanchor ) {
+    _in_anchor = nitems_read(0);
+    _out_anchor = nitems_written(0);
+    _reanchor = false;
+  }
+
+  int nread = 0;
+  int nwritten = 0;
+
+  if ( _bypass ) {
+    nread = nwritten = std::min( noutput_items, ninput_items[0] );
+
+    for (size_t i = 0; i < _nchan; i++)
+      memcpy( output_items[i], input_items[i], nwritten * sizeof(gr_complex) );
+  } else {
+    /* nin inputs yield at most nin * _ratio + 1 outputs */
+    int nin = std::min( int( (noutput_items - 1) / _ratio ),
+                        ninput_items[0] - int( history() ) + 1 - _slack );
+
+    if ( nin <= 0 )
+      return 0;
+
+    for (size_t i = 0; i < _nchan; i++)
+      nwritten = _kernels[i]->filter( (gr_complex *)output_items[i],
+                                      (const gr_complex *)input_items[i],
+                                      nin, nread );
+  }
+
+  propagate_tags( nread, nwritten );
+  consume_each( nread );
+
+  return nwritten;
+}
@@ -0,0 +1,101 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_RESAMPLER_C_H
+#define INCLUDED_RESAMPLER_C_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/filter/pfb_arb_resampler.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <osmosdr/ranges.h>
+
+class resampler_c;
+
+typedef std::shared_ptr< resampler_c > resampler_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of resampler_c.
+ *
+ * \param nchan number of channels of the device
+ */
+resampler_c_sptr make_resampler_c( size_t nchan );
+
+/*!
+ * \brief Delivers arbitrary sample rates from a device with a fixed set.
+ *
+ * Converts all channels of one source device in lock-step with the
+ * polyphase arbitrary resampler of gr-filter, which also covers rational
+ * ratios. When the device delivers the requested rate itself, samples are
+ * passed through unfiltered.
+ *
+ * Tags are moved to the output sample corresponding to their input
+ * sample and rx_rate tags are rewritten to the delivered rate.
+ */
+class resampler_c : public gr::block
+{
+private:
+  friend resampler_c_sptr make_resampler_c( size_t nchan );
+
+  resampler_c( size_t nchan );
+
+public:
+  /* the device rate to resample from: the lowest one not below rate */
+  static double hardware_rate( const osmosdr::meta_range_t &rates, double rate );
+
+  /* the range of rates that may be requested from a device with rates */
+  static osmosdr::meta_range_t output_rates( const osmosdr::meta_range_t &rates );
+
+  /* set the device and the requested rate, returns the delivered rate */
+  double set_rates( double input_rate, double output_rate );
+  double get_sample_rate( void );
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  void propagate_tags( int nread, int nwritten );
+
+  size_t _nchan;
+
+  std::mutex _mutex;
+  std::vector< std::unique_ptr< gr::filter::kernel::pfb_arb_resampler_ccf > > _kernels;
+  bool _bypass;
+  bool _updated;
+  double _input_rate;
+  double _output_rate;
+  double _ratio;
+  int _slack;
+
+  /* input and output sample known to correspond, set after each update */
+  bool _reanchor;
+  uint64_t _in_anchor;
+  uint64_t _out_anchor;
+};
+
+#endif /* INCLUDED_RESAMPLER_C_H */
@@ -36,6 +36,7 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 
 #include <rtl-sdr.h>
@@ -46,6 +47,7 @@ using namespace boost::assign;
 
 #define BUF_LEN  (16 * 32 * 512) /* must be multiple of 512 */
 #define BUF_NUM   15
+#define BUF_MIN    3 /* buffers queued before work() produces output */
 #define BUF_SKIP  1 // buffers to skip due to initial garbage
 
 #define BYTES_PER_SAMPLE  2 // rtl device delivers 8 bit unsigned IQ data
@@ -74,6 +76,8 @@ static const int MAX_IN = 0;	// maximum number of input streams
 static const int MIN_OUT = 1;	// minimum number of output streams
 static const int MAX_OUT = 1;	// maximum number of output streams
 
+static const pmt::pmt_t AGC_KEY = pmt::string_to_symbol("rx_agc");
+
 /*
  * The private constructor
  */
@@ -81,6 +85,7 @@ rtl_source_c::rtl_source_c (const std::string &args)
   : gr::sync_block ("rtl_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+    _lut(true),
     _dev(NULL),
     _buf(NULL),
     _running(false),
@@ -154,19 +159,41 @@ rtl_source_c::rtl_source_c (const std::string &args)
     bias_tee = boost::lexical_cast<bool>( dict["bias"] );
 
   _buf_num = _buf_len = _buf_head = _buf_used = _buf_offset = 0;
+  _samp_queued = 0;
+  _buf_min = BUF_MIN;
+  _latency_stats = false;
 
   if (dict.count("buffers"))
     _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
 
+  if (dict.count("minbuf"))
+    _buf_min = boost::lexical_cast< unsigned int >( dict["minbuf"] );
+
+  if (dict.count("latency_stats"))
+    _latency_stats = boost::lexical_cast< bool >( dict["latency_stats"] );
+
   if (dict.count("buflen"))
     _buf_len = boost::lexical_cast< unsigned int >( dict["buflen"] );
 
+  _decim = 1;
+  if (dict.count("decim"))
+    _decim = boost::lexical_cast< unsigned int >( dict["decim"] );
+
+  if (!iq8_decimator::valid_decimation( _decim ))
+    throw std::runtime_error("Unsupported decimation " + dict["decim"] + ".");
+
+  if (_decim > 1)
+    _decimator.reset( new iq8_decimator( _decim, true ) );
+
   if (0 == _buf_num)
     _buf_num = BUF_NUM;
 
   if (0 == _buf_len || _buf_len % 512 != 0) /* len must be multiple of 512 */
     _buf_len = BUF_LEN;
 
+  /* 1 lets work() drain a partially consumed buffer as soon as it is queued */
+  _buf_min = std::max(1u, std::min(_buf_min, _buf_num));
+
   if ( BUF_NUM != _buf_num || BUF_LEN != _buf_len ) {
     std::cerr << "Using " << _buf_num << " buffers of size " << _buf_len << "."
               << std::endl;
@@ -174,10 +201,6 @@ rtl_source_c::rtl_source_c (const std::string &args)
 
   _samp_avail = _buf_len / BYTES_PER_SAMPLE;
 
-  // create a lookup table for gr_complex values
-  for (unsigned int i = 0; i < 0x100; i++)
-    _lut.push_back((i - 127.4f) / 128.0f);
-
   _dev = NULL;
   ret = rtlsdr_open( &_dev, dev_index );
   if (ret < 0)
@@ -236,6 +259,8 @@ rtl_source_c::rtl_source_c (const std::string &args)
     for(unsigned int i = 0; i < _buf_num; ++i)
       _buf[i] = (unsigned char *)malloc(_buf_len);
   }
+
+  _latency.resize(_buf_num);
 }
 
 /*
@@ -267,6 +292,11 @@ rtl_source_c::~rtl_source_c ()
 
 bool rtl_source_c::start()
 {
+  _samp_queued = 0;
+  _latency.reset();
+  if (_decimator)
+    _decimator->reset();
+  _dc.set_sample_rate( get_sample_rate() * _decim );
   _running = true;
   _thread = gr::thread::thread(_rtlsdr_wait, this);
 
@@ -280,6 +310,12 @@ bool rtl_source_c::stop()
     rtlsdr_cancel_async( _dev );
   _thread.join();
 
+  if (_latency_stats) {
+    std::lock_guard<std::mutex> lock( _buf_mutex );
+    std::cerr << "rtl_source_c: callback to work latency: "
+              << _latency.summary() << std::endl;
+  }
+
   return true;
 }
 
@@ -301,13 +337,19 @@ void rtl_source_c::rtlsdr_callback(unsigned char *buf, uint32_t len)
 
     int buf_tail = (_buf_head + _buf_used) % _buf_num;
     memcpy(_buf[buf_tail], buf, len);
+    _latency.stamp(buf_tail);
 
     if (_buf_used == _buf_num) {
       std::cerr << "O" << std::flush;
       _buf_head = (_buf_head + 1) % _buf_num;
     } else {
       _buf_used++;
+      _samp_queued += len / BYTES_PER_SAMPLE; /* an overrun replaces samples */
     }
+
+    /* only wake work() once it has something to do */
+    if (_buf_used < _buf_min)
+      return;
   }
 
   _buf_cond.notify_one();
@@ -339,22 +381,42 @@ int rtl_source_c::work( int noutput_items,
   {
     std::unique_lock<std::mutex> lock( _buf_mutex );
 
-    while (_buf_used < 3 && _running) // collect at least 3 buffers
+    while (_buf_used < _buf_min && _running)
       _buf_cond.wait( lock );
   }
 
   if (!_running)
     return WORK_DONE;
 
+  std::complex<double> dc = _lut.update( _dc );
+  if (_decimator)
+    _decimator->set_dc_offset( dc );
+
+  float gain;
+  if ( _lut.update_gain( gain ) )
+    add_item_tag( 0, nitems_written(0), AGC_KEY, pmt::from_double( gain ) );
+
   while (noutput_items && _buf_used) {
     const int nout = std::min(noutput_items, _samp_avail);
     const unsigned char *buf = _buf[_buf_head] + _buf_offset * 2;
+    int nin = nout;
 
-    for (int i = 0; i < nout; ++i)
-      *out++ = gr_complex(_lut[buf[i * 2]], _lut[buf[i * 2 + 1]]);
+    if (0 == _buf_offset)
+      _latency.consumed(_buf_head);
 
-    noutput_items -= nout;
-    _samp_avail -= nout;
+    if (_decimator) {
+      /* at most one output per _decim inputs, so this never overflows out */
+      nin = (int)std::min< size_t >( size_t(noutput_items) * _decim, _samp_avail );
+      size_t produced = _decimator->process( out, buf, nin );
+      out += produced;
+      noutput_items -= produced;
+    } else {
+      _lut.convert( out, buf, nout, _dc );
+      out += nout;
+      noutput_items -= nout;
+    }
+
+    _samp_avail -= nin;
 
     if (!_samp_avail) {
       {
@@ -366,13 +428,27 @@ int rtl_source_c::work( int noutput_items,
       _samp_avail = _buf_len / BYTES_PER_SAMPLE;
       _buf_offset = 0;
     } else {
-      _buf_offset += nout;
+      _buf_offset += nin;
     }
   }
 
+  if (_decimator) {
+    size_t nin;
+    std::complex<double> sum = _decimator->take_input_sum( nin );
+    _dc.update( sum, nin );
+  }
+
   return (out - ((gr_complex *)output_items[0]));
 }
 
+uint64_t rtl_source_c::get_capture_index( size_t chan )
+{
+  std::lock_guard<std::mutex> lock( _buf_mutex );
+
+  /* one more transfer may be filling up in the USB stack */
+  return (_samp_queued + _buf_len / BYTES_PER_SAMPLE) / _decim;
+}
+
 std::vector<std::string> rtl_source_c::get_devices()
 {
   std::vector<std::string> devices;
@@ -432,13 +508,23 @@ osmosdr::meta_range_t rtl_source_c::get_sample_rates()
 //  range += osmosdr::range_t( 3000000 ); // may work
 //  range += osmosdr::range_t( 3200000 ); // max rate
 
+  if (_decim > 1) {
+    osmosdr::meta_range_t decimated;
+
+    for (const osmosdr::range_t &r : range)
+      decimated += osmosdr::range_t( r.start() / _decim );
+
+    return decimated;
+  }
+
   return range;
 }
 
 double rtl_source_c::set_sample_rate(double rate)
 {
   if (_dev) {
-    rtlsdr_set_sample_rate( _dev, (uint32_t)rate );
+    rtlsdr_set_sample_rate( _dev, (uint32_t)(rate * _decim) );
+    _dc.set_sample_rate( get_sample_rate() * _decim );
   }
 
   return get_sample_rate();
@@ -447,7 +533,7 @@ double rtl_source_c::set_sample_rate(double rate)
 double rtl_source_c::get_sample_rate()
 {
   if (_dev)
-    return (double)rtlsdr_get_sample_rate( _dev );
+    return (double)rtlsdr_get_sample_rate( _dev ) / _decim;
 
   return 0;
 }
@@ -590,6 +676,17 @@ bool rtl_source_c::get_gain_mode( size_t chan )
   return _auto_gain;
 }
 
+bool rtl_source_c::set_software_agc( agc_tracker *agc, size_t chan )
+{
+  if ( _decimator )
+    return false;
+
+  /* the conversion table measures and applies it in the integer domain */
+  _lut.set_agc( agc );
+
+  return true;
+}
+
 double rtl_source_c::set_gain( double gain, size_t chan )
 {
   osmosdr::gain_range_t rf_gains = rtl_source_c::get_gain_range( chan );
@@ -710,3 +807,13 @@ std::string rtl_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+void rtl_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _dc.set_mode( mode );
+}
+
+void rtl_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _dc.set_offset( offset * 128.0 );
+}
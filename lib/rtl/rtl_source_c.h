@@ -28,8 +28,13 @@
 
 #include <mutex>
 #include <condition_variable>
+#include <memory>
 
 #include "source_iface.h"
+#include "buffer_latency.h"
+#include "iq8_decimator.h"
+#include "iq8_lut.h"
+#include "dc_tracker.h"
 
 class rtl_source_c;
 typedef struct rtlsdr_dev rtlsdr_dev_t;
@@ -102,6 +107,7 @@ public:
   osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
   bool set_gain_mode( bool automatic, size_t chan = 0 );
   bool get_gain_mode( size_t chan = 0 );
+  bool set_software_agc( agc_tracker *agc, size_t chan = 0 );
   double set_gain( double gain, size_t chan = 0 );
   double set_gain( double gain, const std::string & name, size_t chan = 0 );
   double get_gain( size_t chan = 0 );
@@ -113,6 +119,12 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  bool has_dc_offset_correction( size_t chan = 0 ) { return true; }
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
+  uint64_t get_capture_index( size_t chan = 0 );
+
 protected:
   bool start();
   bool stop();
@@ -123,7 +135,8 @@ private:
   static void _rtlsdr_wait(rtl_source_c *obj);
   void rtlsdr_wait();
 
-  std::vector<float> _lut;
+  iq8_lut _lut;
+  dc_tracker _dc;
 
   rtlsdr_dev_t *_dev;
   gr::thread::thread _thread;
@@ -132,12 +145,20 @@ private:
   unsigned int _buf_len;
   unsigned int _buf_head;
   unsigned int _buf_used;
+  unsigned int _buf_min;
   std::mutex _buf_mutex;
   std::condition_variable _buf_cond;
   bool _running;
 
   unsigned int _buf_offset;
+
+  buffer_latency _latency;
+  bool _latency_stats;
   int _samp_avail;
+  uint64_t _samp_queued;
+
+  unsigned int _decim;
+  std::unique_ptr<iq8_decimator> _decimator;
 
   bool _no_tuner;
   bool _auto_gain;
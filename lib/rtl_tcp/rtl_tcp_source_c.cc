@@ -60,6 +60,8 @@ typedef ptrdiff_t ssize_t;
 
 #define BYTES_PER_SAMPLE  2 // rtl_tcp device delivers 8 bit unsigned IQ data
 
+static const pmt::pmt_t AGC_KEY = pmt::string_to_symbol("rx_agc");
+
 /* copied from rtl sdr code */
 typedef struct { /* structure size must be multiple of 2 bytes */
   char magic[4];
@@ -149,7 +151,8 @@ rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
   d_socket(-1),
   _no_tuner(false),
   _auto_gain(false),
-  _if_gain(0)
+  _if_gain(0),
+  d_lut(true)
 {
   std::string host = "127.0.0.1";
   unsigned short port = 1234;
@@ -224,9 +227,6 @@ rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
                  "can't initialize source socket" );
 
   d_temp_buff = new unsigned char[payload_size];   // allow it to hold up to payload_size bytes
-  d_LUT = new float[0x100];
-  for (int i = 0; i < 0x100; ++i)
-    d_LUT[i] = (((float)(i & 0xff)) - 127.4f) * (1.0f / 128.0f);
 
   // create socket
   d_socket = socket(ip_src->ai_family, ip_src->ai_socktype,
@@ -315,7 +315,6 @@ rtl_tcp_source_c::rtl_tcp_source_c(const std::string &args) :
 
 rtl_tcp_source_c::~rtl_tcp_source_c()
 {
-  delete [] d_LUT;
   delete [] d_temp_buff;
 
   if (d_socket != -1) {
@@ -354,8 +353,11 @@ int rtl_tcp_source_c::work(int noutput_items,
     index += receivedbytes;
   }
 
-  for (int i = 0; i < noutput_items; i++)
-    out[i] = gr_complex(d_LUT[d_temp_buff[i * 2]], d_LUT[d_temp_buff[i * 2 + 1]]);
+  float gain;
+  d_lut.update(d_dc);
+  if (d_lut.update_gain(gain))
+    add_item_tag(0, nitems_written(0), AGC_KEY, pmt::from_double(gain));
+  d_lut.convert(out, d_temp_buff, noutput_items, d_dc);
 
   return noutput_items;
 }
@@ -411,6 +413,7 @@ double rtl_tcp_source_c::set_sample_rate( double rate )
   send(d_socket, (const char*)&cmd, sizeof(cmd), 0);
 
   _rate = rate;
+  d_dc.set_sample_rate(rate);
 
   return get_sample_rate();
 }
@@ -581,6 +584,14 @@ bool rtl_tcp_source_c::get_gain_mode( size_t chan )
   return _auto_gain;
 }
 
+bool rtl_tcp_source_c::set_software_agc( agc_tracker *agc, size_t chan )
+{
+  /* the conversion table measures and applies it in the integer domain */
+  d_lut.set_agc( agc );
+
+  return true;
+}
+
 double rtl_tcp_source_c::set_gain( double gain, size_t chan )
 {
   osmosdr::gain_range_t gains = rtl_tcp_source_c::get_gain_range( chan );
@@ -698,3 +709,13 @@ std::string rtl_tcp_source_c::get_antenna( size_t chan )
 {
   return "RX";
 }
+
+void rtl_tcp_source_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  d_dc.set_mode(mode);
+}
+
+void rtl_tcp_source_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  d_dc.set_offset(offset * 128.0);
+}
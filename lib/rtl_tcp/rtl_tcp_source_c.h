@@ -23,6 +23,8 @@
 #include <gnuradio/sync_block.h>
 
 #include "source_iface.h"
+#include "iq8_lut.h"
+#include "dc_tracker.h"
 
 class rtl_tcp_source_c;
 
@@ -79,6 +81,7 @@ public:
   osmosdr::gain_range_t get_gain_range( const std::string & name, size_t chan = 0 );
   bool set_gain_mode( bool automatic, size_t chan = 0 );
   bool get_gain_mode( size_t chan = 0 );
+  bool set_software_agc( agc_tracker *agc, size_t chan = 0 );
   double set_gain( double gain, size_t chan = 0 );
   double set_gain( double gain, const std::string & name, size_t chan = 0 );
   double get_gain( size_t chan = 0 );
@@ -90,6 +93,10 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  bool has_dc_offset_correction( size_t chan = 0 ) { return true; }
+  void set_dc_offset_mode( int mode, size_t chan = 0 );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
+
 private:
   int d_socket;		  // handle to socket
   double _freq, _rate, _gain, _corr;
@@ -101,7 +108,8 @@ private:
   unsigned int d_tuner_gain_count;
   unsigned int d_tuner_if_gain_count;
   unsigned char *d_temp_buff; // hold buffer between calls
-  float *d_LUT;
+  iq8_lut d_lut;
+  dc_tracker d_dc;
 };
 
 #endif // RTL_TCP_SOURCE_C_H
@@ -38,8 +38,14 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 #include <stdio.h>
 #include <math.h>
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
 
 #include <mirsdrapi-rsp.h>
 
@@ -78,6 +84,11 @@ using namespace boost::assign;
 #define SDRPLAY_L_MAX     1675e6
 
 #define SDRPLAY_MAX_BUF_SIZE 504
+#define SDRPLAY_BUF_NUM       64 // packets read ahead by the reader thread
+
+static const pmt::pmt_t GAIN_KEY = pmt::string_to_symbol("rx_gain");
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t RATE_KEY = pmt::string_to_symbol("rx_rate");
 
 /*
  * Create a new instance of sdrplay_source_c and return
@@ -110,10 +121,22 @@ sdrplay_source_c::sdrplay_source_c (const std::string &args)
   : gr::sync_block ("sdrplay_source_c",
         gr::io_signature::make(MIN_IN, MAX_IN, sizeof (gr_complex)),
         gr::io_signature::make(MIN_OUT, MAX_OUT, sizeof (gr_complex))),
+    _dev_changed(false),
+    _buf_num(SDRPLAY_BUF_NUM),
+    _buf_head(0),
+    _buf_used(0),
+    _buf_offset(0),
     _running(false),
-    _uninit(false),
     _auto_gain(false)
 {
+   dict_t dict = params_to_dict(args);
+
+   if (dict.count("buffers"))
+      _buf_num = boost::lexical_cast< unsigned int >( dict["buffers"] );
+
+   if (0 == _buf_num)
+      _buf_num = SDRPLAY_BUF_NUM;
+
    _dev = (sdrplay_dev_t *)malloc(sizeof(sdrplay_dev_t));
    if (_dev == NULL)
    {
@@ -128,13 +151,10 @@ sdrplay_source_c::sdrplay_source_c (const std::string &args)
    _dev->gRdB = 60;
    set_gain_limits(_dev->rfHz);
    _dev->gain_dB = _dev->maxGain - _dev->gRdB;
-   
-   _bufi.reserve(SDRPLAY_MAX_BUF_SIZE);
-   _bufq.reserve(SDRPLAY_MAX_BUF_SIZE);   
 
-   _buf_mutex.lock();
-   _buf_offset = 0;
-   _buf_mutex.unlock();
+   _bufi.resize(_buf_num * SDRPLAY_MAX_BUF_SIZE);
+   _bufq.resize(_buf_num * SDRPLAY_MAX_BUF_SIZE);
+   _pkts.resize(_buf_num);
 }
 
 /*
@@ -142,22 +162,61 @@ sdrplay_source_c::sdrplay_source_c (const std::string &args)
  */
 sdrplay_source_c::~sdrplay_source_c ()
 {
+   stop();
+
    free(_dev);
    _dev = NULL;
-   _buf_mutex.lock();
+}
+
+bool sdrplay_source_c::start()
+{
    if (_running)
+      return true;
+
+   {
+      std::lock_guard<std::mutex> lock( _dev_mutex );
+
+      reinit_device();
+   }
+
+   {
+      std::lock_guard<std::mutex> lock( _buf_mutex );
+
+      _buf_head = _buf_used = 0;
+      _buf_offset = 0;
+      _running = true;
+   }
+
+   _thread = gr::thread::thread(_sdrplay_wait, this);
+
+   return true;
+}
+
+bool sdrplay_source_c::stop()
+{
    {
+      std::lock_guard<std::mutex> lock( _buf_mutex );
+
+      if (!_running)
+         return true;
+
       _running = false;
    }
-   _uninit = true;
-   _buf_mutex.unlock();
+   _buf_cond.notify_all();
+
+   if (_thread.joinable())
+      _thread.join();
+
+   std::lock_guard<std::mutex> lock( _dev_mutex );
+   mir_sdr_Uninit();
+
+   return true;
 }
 
+/* must be called with _dev_mutex held */
 void sdrplay_source_c::reinit_device()
 {
    std::cerr << "reinit_device started" << std::endl;
-   _buf_mutex.lock();
-   std::cerr << "after mutex.lock" << std::endl;
    if (_running)
    {
       std::cerr << "mir_sdr_Uninit started" << std::endl;
@@ -173,8 +232,8 @@ void sdrplay_source_c::reinit_device()
       mir_sdr_SetDcMode(4, 1);
    }
 
-   _buf_offset = 0;
-   _buf_mutex.unlock();
+   /* everything may have changed, tag all settings on the next packet */
+   _dev_changed = true;
    std::cerr << "reinit_device end" << std::endl;
 }
 
@@ -207,62 +266,183 @@ void sdrplay_source_c::set_gain_limits(double freq)
    }
 }
 
+void sdrplay_source_c::_sdrplay_wait(sdrplay_source_c *obj)
+{
+   obj->sdrplay_wait();
+}
+
+void sdrplay_source_c::sdrplay_wait()
+{
+   while (true)
+   {
+      unsigned int tail;
+
+      {
+         std::unique_lock<std::mutex> lock( _buf_mutex );
+
+         while (_buf_used == _buf_num && _running)
+            _buf_cond.wait( lock );
+
+         if (!_running)
+            break;
+
+         tail = (_buf_head + _buf_used) % _buf_num;
+      }
+
+      packet_info &pkt = _pkts[tail];
+      unsigned int sampNum;
+      int grChanged;
+      int rfChanged;
+      int fsChanged;
+
+      /* the read blocks, setters must not queue behind it */
+      mir_sdr_ReadPacket(&_bufi[tail * SDRPLAY_MAX_BUF_SIZE],
+                         &_bufq[tail * SDRPLAY_MAX_BUF_SIZE],
+                         &sampNum, &grChanged, &rfChanged, &fsChanged);
+
+      {
+         std::lock_guard<std::mutex> lock( _dev_mutex );
+
+         pkt.samples = std::min(_dev->samplesPerPacket, SDRPLAY_MAX_BUF_SIZE);
+         pkt.grChanged = grChanged || _dev_changed;
+         pkt.rfChanged = rfChanged || _dev_changed;
+         pkt.fsChanged = fsChanged || _dev_changed;
+         pkt.gain_dB = _dev->gain_dB;
+         pkt.rfHz = _dev->rfHz;
+         pkt.fsHz = _dev->fsHz;
+         _dev_changed = false;
+      }
+
+      {
+         std::lock_guard<std::mutex> lock( _buf_mutex );
+
+         _buf_used++;
+      }
+      _buf_cond.notify_one();
+   }
+}
+
+/* Interleave the separate 12 bit I and Q vectors and scale them to +-1.0 */
+static void convert_default(gr_complex *out, const short *bufi, const short *bufq,
+                            const unsigned int count)
+{
+   for (unsigned int i = 0; i < count; i++)
+   {
+      out[i] = gr_complex( float(bufi[i]) * (1.0f/2048.0f), float(bufq[i]) * (1.0f/2048.0f) );
+   }
+}
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+/* count is in blocks of 8 samples */
+static void convert_sse2(gr_complex *out, const short *bufi, const short *bufq,
+                         const unsigned int count)
+{
+   const __m128 scale = _mm_set1_ps( 1.0f/2048.0f );
+
+   for (unsigned int i = 0; i < count; i++)
+   {
+      __m128i vi = _mm_loadu_si128((const __m128i *)&bufi[i*8]);
+      __m128i vq = _mm_loadu_si128((const __m128i *)&bufq[i*8]);
+
+      /* i0 q0 i1 q1 ... as shorts */
+      __m128i lo = _mm_unpacklo_epi16(vi, vq);
+      __m128i hi = _mm_unpackhi_epi16(vi, vq);
+
+      /* duplicating each short into both halves of a 32 bit lane and
+       * shifting right arithmetically sign extends it */
+      __m128 f0 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16));
+      __m128 f1 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16));
+      __m128 f2 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16));
+      __m128 f3 = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16));
+
+      float *o = (float *)&out[i*8];
+      _mm_storeu_ps(o + 0,  _mm_mul_ps(f0, scale));
+      _mm_storeu_ps(o + 4,  _mm_mul_ps(f1, scale));
+      _mm_storeu_ps(o + 8,  _mm_mul_ps(f2, scale));
+      _mm_storeu_ps(o + 12, _mm_mul_ps(f3, scale));
+   }
+}
+#endif
+
+static void convert_iq(gr_complex *out, const short *bufi, const short *bufq,
+                       const unsigned int count)
+{
+#if defined(USE_SSE2) || defined(USE_AVX)
+   unsigned int sse_rem = count/8;
+   unsigned int nosse_rem = count%8;
+
+   convert_sse2(out, bufi, bufq, sse_rem);
+   convert_default(out + sse_rem*8, bufi + sse_rem*8, bufq + sse_rem*8, nosse_rem);
+#else
+   convert_default(out, bufi, bufq, count);
+#endif
+}
+
 int sdrplay_source_c::work( int noutput_items,
                             gr_vector_const_void_star &input_items,
                             gr_vector_void_star &output_items )
 {
    gr_complex *out = (gr_complex *)output_items[0];
-   int cnt = noutput_items;
-   unsigned int sampNum;
-   int grChanged;
-   int rfChanged;
-   int fsChanged;
+   int produced = 0;
 
-   if (_uninit)
    {
-      return WORK_DONE;
+      std::unique_lock<std::mutex> lock( _buf_mutex );
+
+      while (_buf_used < 1 && _running)
+         _buf_cond.wait( lock );
    }
 
    if (!_running)
    {
-      reinit_device();
-      _running = true;
+      return WORK_DONE;
    }
 
-   _buf_mutex.lock();
-
-   if (_buf_offset)
+   while (produced < noutput_items)
    {
-      for (int i = _buf_offset; i < _dev->samplesPerPacket; i++)
       {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
+         std::lock_guard<std::mutex> lock( _buf_mutex );
+
+         if (!_buf_used)
+            break;
       }
-      cnt -= (_dev->samplesPerPacket - _buf_offset);
-   }
 
-   while ((cnt - _dev->samplesPerPacket) >= 0)
-   {
-      mir_sdr_ReadPacket(_bufi.data(), _bufq.data(), &sampNum, &grChanged, &rfChanged, &fsChanged);
-      for (int i = 0; i < _dev->samplesPerPacket; i++)
+      /* only work() moves the head, no need to hold the lock here */
+      const packet_info &pkt = _pkts[_buf_head];
+
+      if (_buf_offset == 0)
       {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
+         const uint64_t offset = nitems_written(0) + produced;
+
+         if (pkt.grChanged)
+            add_item_tag(0, offset, GAIN_KEY, pmt::from_double(pkt.gain_dB));
+         if (pkt.rfChanged)
+            add_item_tag(0, offset, FREQ_KEY, pmt::from_double(pkt.rfHz));
+         if (pkt.fsChanged)
+            add_item_tag(0, offset, RATE_KEY, pmt::from_double(pkt.fsHz));
       }
-      cnt -= _dev->samplesPerPacket;
-   }
 
-   _buf_offset = 0;
-   if (cnt)
-   {
-      mir_sdr_ReadPacket(_bufi.data(), _bufq.data(), &sampNum, &grChanged, &rfChanged, &fsChanged);
-      for (int i = 0; i < cnt; i++)
+      const int nout = std::min(noutput_items - produced, pkt.samples - _buf_offset);
+      const size_t base = _buf_head * SDRPLAY_MAX_BUF_SIZE + _buf_offset;
+
+      convert_iq(out + produced, &_bufi[base], &_bufq[base], nout);
+
+      produced += nout;
+      _buf_offset += nout;
+
+      if (_buf_offset >= pkt.samples)
       {
-         *out++ = gr_complex( float(_bufi[i]) * (1.0f/2048.0f), float(_bufq[i]) * (1.0f/2048.0f) );
+         {
+            std::lock_guard<std::mutex> lock( _buf_mutex );
+
+            _buf_head = (_buf_head + 1) % _buf_num;
+            _buf_used--;
+         }
+         _buf_cond.notify_one();
+         _buf_offset = 0;
       }
-      _buf_offset = cnt;
    }
-   _buf_mutex.unlock();
 
-   return noutput_items;
+   return produced;
 }
 
 std::vector<std::string> sdrplay_source_c::get_devices()
@@ -310,22 +490,26 @@ osmosdr::meta_range_t sdrplay_source_c::get_sample_rates()
 double sdrplay_source_c::set_sample_rate(double rate)
 {
    std::cerr << "set_sample_rate start" << std::endl;
-   double diff = rate - _dev->fsHz;
-   _dev->fsHz = rate;
-
-   std::cerr << "rate = " << rate << std::endl;
-   std::cerr << "diff = " << diff << std::endl;
-   if (_running) 
    {
-      if (fabs(diff) < 10000.0)
-      {
-         std::cerr << "mir_sdr_SetFs started" << std::endl;
-         mir_sdr_SetFs(diff, 0, 0, 0);
-      }
-      else
+      /* the reader thread tags packets with these fields */
+      std::lock_guard<std::mutex> lock( _dev_mutex );
+
+      double diff = rate - _dev->fsHz;
+      _dev->fsHz = rate;
+
+      std::cerr << "rate = " << rate << std::endl;
+      std::cerr << "diff = " << diff << std::endl;
+      if (_running)
       {
-         std::cerr << "reinit_device started" << std::endl;
-         reinit_device();
+         if (fabs(diff) < 10000.0)
+         {
+            std::cerr << "mir_sdr_SetFs started" << std::endl;
+            mir_sdr_SetFs(diff, 0, 0, 0);
+         }
+         else
+         {
+            reinit_device();
+         }
       }
    }
    std::cerr << "set_sample_rate end" << std::endl;
@@ -361,21 +545,24 @@ double sdrplay_source_c::set_center_freq( double freq, size_t chan )
 {
    std::cerr << "set_center_freq start" << std::endl;
    std::cerr << "freq = " << freq << std::endl;
-   double diff = freq - _dev->rfHz;
-   std::cerr << "diff = " << diff << std::endl;
-   _dev->rfHz = freq;
-   set_gain_limits(freq);
-   if (_running) 
    {
-      if (fabs(diff) < 10000.0)
-      {
-         std::cerr << "mir_sdr_SetRf started" << std::endl;
-         mir_sdr_SetRf(diff, 0, 0);
-      }
-      else
+      std::lock_guard<std::mutex> lock( _dev_mutex );
+
+      double diff = freq - _dev->rfHz;
+      std::cerr << "diff = " << diff << std::endl;
+      _dev->rfHz = freq;
+      set_gain_limits(freq);
+      if (_running)
       {
-         std::cerr << "reinit_device started" << std::endl;
-         reinit_device();
+         if (fabs(diff) < 10000.0)
+         {
+            std::cerr << "mir_sdr_SetRf started" << std::endl;
+            mir_sdr_SetRf(diff, 0, 0);
+         }
+         else
+         {
+            reinit_device();
+         }
       }
    }
 
@@ -453,22 +640,26 @@ bool sdrplay_source_c::get_gain_mode( size_t chan )
 double sdrplay_source_c::set_gain( double gain, size_t chan )
 {
    std::cerr << "set_gain started" << std::endl;
-   _dev->gain_dB = gain;
-   std::cerr << "gain = " << gain << std::endl;
-   if (gain < _dev->minGain)
-   {
-      _dev->gain_dB = _dev->minGain;
-   }
-   if (gain > _dev->maxGain)
    {
-      _dev->gain_dB = _dev->maxGain;
-   }
-   _dev->gRdB = (int)(_dev->maxGain - gain);
+      std::lock_guard<std::mutex> lock( _dev_mutex );
 
-   if (_running) 
-   {
-      std::cerr << "mir_sdr_SetGr started" << std::endl;
-      mir_sdr_SetGr(_dev->gRdB, 1, 0);
+      _dev->gain_dB = gain;
+      std::cerr << "gain = " << gain << std::endl;
+      if (gain < _dev->minGain)
+      {
+         _dev->gain_dB = _dev->minGain;
+      }
+      if (gain > _dev->maxGain)
+      {
+         _dev->gain_dB = _dev->maxGain;
+      }
+      _dev->gRdB = (int)(_dev->maxGain - gain);
+
+      if (_running)
+      {
+         std::cerr << "mir_sdr_SetGr started" << std::endl;
+         mir_sdr_SetGr(_dev->gRdB, 1, 0);
+      }
    }
 
 std::cerr << "set_gain end" << std::endl;
@@ -517,6 +708,8 @@ std::string sdrplay_source_c::get_antenna( size_t chan )
 
 void sdrplay_source_c::set_dc_offset_mode( int mode, size_t chan )
 {
+   std::lock_guard<std::mutex> lock( _dev_mutex );
+
    if ( osmosdr::source::DCOffsetOff == mode ) 
    {
       _dev->dcMode = 0;
@@ -551,6 +744,8 @@ void sdrplay_source_c::set_dc_offset( const std::complex<double> &offset, size_t
 
 double sdrplay_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
+   std::lock_guard<std::mutex> lock( _dev_mutex );
+
    if      (bandwidth <= 200e3)  _dev->bwType = mir_sdr_BW_0_200;
    else if (bandwidth <= 300e3)  _dev->bwType = mir_sdr_BW_0_300;
    else if (bandwidth <= 600e3)  _dev->bwType = mir_sdr_BW_0_600;
@@ -83,6 +83,9 @@ public:
             gr_vector_const_void_star &input_items,
             gr_vector_void_star &output_items );
 
+   bool start();
+   bool stop();
+
    static std::vector< std::string > get_devices();
 
    size_t get_num_channels( void );
@@ -111,9 +114,12 @@ public:
    std::string set_antenna( const std::string & antenna, size_t chan = 0 );
    std::string get_antenna( size_t chan = 0 );
 
+   bool has_dc_offset_correction( size_t chan = 0 ) { return true; }
    void set_dc_offset_mode( int mode, size_t chan = 0 );
    void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
 
+   bool has_retune_tags( void ) { return true; }
+
    double set_bandwidth( double bandwidth, size_t chan = 0 );
    double get_bandwidth( size_t chan = 0 );
    osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 );
@@ -122,15 +128,37 @@ private:
    void reinit_device(void);
    void set_gain_limits(double freq);
 
+   static void _sdrplay_wait(sdrplay_source_c *obj);
+   void sdrplay_wait();
+
+   /* settings in effect when a packet was read, tagged if changed */
+   struct packet_info
+   {
+      int samples;
+      bool grChanged;
+      bool rfChanged;
+      bool fsChanged;
+      double gain_dB;
+      double rfHz;
+      double fsHz;
+   };
+
    sdrplay_dev_t *_dev;
+   std::mutex _dev_mutex;
+   bool _dev_changed;
 
+   gr::thread::thread _thread;
    std::vector< short > _bufi;
    std::vector< short > _bufq;
+   std::vector< packet_info > _pkts;
+   unsigned int _buf_num;
+   unsigned int _buf_head;
+   unsigned int _buf_used;
    int _buf_offset;
    std::mutex _buf_mutex;
+   std::condition_variable _buf_cond;
 
    bool _running;
-   bool _uninit;
    bool _auto_gain;
 };
 
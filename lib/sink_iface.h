@@ -366,6 +366,21 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) { }
+
+  /*!
+   * Set the time at which subsequent commands take effect.
+   * \param time_spec the time at which the commands take effect
+   * \param mboard the motherboard index 0 to M-1
+   * \return true if the device executes timed commands itself
+   */
+  virtual bool set_command_time(const ::osmosdr::time_spec_t &time_spec,
+                                size_t mboard = 0) { return false; }
+
+  /*!
+   * Clear the command time so subsequent commands take effect immediately.
+   * \param mboard the motherboard index 0 to M-1
+   */
+  virtual void clear_command_time(size_t mboard = 0) { }
 };
 
 #endif // OSMOSDR_SINK_IFACE_H
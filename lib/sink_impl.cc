@@ -79,6 +79,9 @@ sink_impl::sink_impl( const std::string &args )
 {
   size_t channel = 0;
   bool device_specified = false;
+#ifdef ENABLE_FILE
+  bool trigger_port = false;
+#endif
 
   std::vector< std::string > arg_list = args_to_vector(args);
 
@@ -229,15 +232,40 @@ sink_impl::sink_impl( const std::string &args )
     if ( dict.count("file") ) {
       file_sink_c_sptr sink = make_file_sink_c( arg );
       block = sink; iface = sink.get();
+
+      /* pass pre-trigger capture requests on to the file */
+      if ( sink->has_trigger() ) {
+        if ( !trigger_port ) {
+          message_port_register_hier_in( pmt::mp("trigger") );
+          trigger_port = true;
+        }
+        msg_connect( self(), "trigger", sink, "trigger" );
+      }
     }
 #endif
 
     if (iface != NULL && reinterpret_cast<std::intptr_t>(block.get()) != 0) {
       _devs.push_back( iface );
+      _lo_offsets.push_back( 0 );
+      _ncos.push_back( std::vector< gr::blocks::rotator_cc::sptr >() );
+
+      /* uhd offsets its LO by itself */
+      if ( dict.count("lo_offset") && ! dict.count("uhd") )
+        _lo_offsets.back() = boost::lexical_cast<double>( dict["lo_offset"] );
 
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
-        connect(self(), channel++, block, i);
+        if ( 0 != _lo_offsets.back() ) {
+          gr::blocks::rotator_cc::sptr nco = gr::blocks::rotator_cc::make();
+
+          connect(self(), channel++, nco, 0);
+          connect(nco, 0, block, i);
+          _ncos.back().push_back( nco );
+        } else {
+          connect(self(), channel++, block, i);
+        }
       }
+
+      update_lo_offset( _devs.size() - 1 );
     } else if ((iface != NULL) || (reinterpret_cast<std::intptr_t>(block.get()) != 0))
       throw std::runtime_error("Either iface or block are NULL.");
 
@@ -264,6 +292,18 @@ size_t sink_impl::get_num_channels()
   return channels;
 }
 
+void sink_impl::update_lo_offset( size_t dev )
+{
+  double rate = _devs[dev]->get_sample_rate();
+
+  if ( rate <= 0 )
+    return;
+
+  /* the device is tuned lo_offset above the center, shift down to meet it */
+  for ( gr::blocks::rotator_cc::sptr &nco : _ncos[dev] )
+    nco->set_phase_inc( -2 * M_PI * _lo_offsets[dev] / rate );
+}
+
 #define NO_DEVICES_MSG  "FATAL: No device(s) available to work with."
 
 osmosdr::meta_range_t sink_impl::get_sample_rates()
@@ -286,8 +326,10 @@ double sink_impl::set_sample_rate(double rate)
     if (_devs.empty())
       throw std::runtime_error(NO_DEVICES_MSG);
 #endif
-    for (sink_iface *dev : _devs)
-      sample_rate = dev->set_sample_rate(rate);
+    for (size_t i = 0; i < _devs.size(); i++) {
+      sample_rate = _devs[i]->set_sample_rate(rate);
+      update_lo_offset( i );
+    }
 
     _sample_rate = sample_rate;
   }
@@ -322,12 +364,12 @@ osmosdr::freq_range_t sink_impl::get_freq_range( size_t chan )
 double sink_impl::set_center_freq( double freq, size_t chan )
 {
   size_t channel = 0;
-  for (sink_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ ) {
         if ( _center_freq[ chan ] != freq ) {
           _center_freq[ chan ] = freq;
-          return dev->set_center_freq( freq, dev_chan );
+          return _devs[i]->set_center_freq( freq + _lo_offsets[i], dev_chan ) - _lo_offsets[i];
         } else { return _center_freq[ chan ]; }
       }
 
@@ -337,10 +379,10 @@ double sink_impl::set_center_freq( double freq, size_t chan )
 double sink_impl::get_center_freq( size_t chan )
 {
   size_t channel = 0;
-  for (sink_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ )
-        return dev->get_center_freq( dev_chan );
+        return _devs[i]->get_center_freq( dev_chan ) - _lo_offsets[i];
 
   return 0;
 }
@@ -701,3 +743,32 @@ void sink_impl::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
     dev->set_time_unknown_pps( time_spec );
   }
 }
+
+void sink_impl::set_command_time(const osmosdr::time_spec_t &time_spec, size_t mboard)
+{
+  /* sinks have no stream to emulate it on, a retune would happen right away */
+  if (mboard != osmosdr::ALL_MBOARDS){
+      if ( !_devs.at(mboard)->set_command_time( time_spec ) )
+        throw std::runtime_error("Timed commands are not supported by this device.");
+      return;
+  }
+
+  for (size_t m = 0; m < _devs.size(); m++){ /* propagate ALL_MBOARDS */
+      if ( !_devs.at(m)->set_command_time( time_spec, osmosdr::ALL_MBOARDS ) ) {
+        clear_command_time( osmosdr::ALL_MBOARDS );
+        throw std::runtime_error("Timed commands are not supported by all devices.");
+      }
+  }
+}
+
+void sink_impl::clear_command_time(size_t mboard)
+{
+  if (mboard != osmosdr::ALL_MBOARDS){
+      _devs.at(mboard)->clear_command_time();
+      return;
+  }
+
+  for (size_t m = 0; m < _devs.size(); m++){ /* propagate ALL_MBOARDS */
+      _devs.at(m)->clear_command_time( osmosdr::ALL_MBOARDS );
+  }
+}
@@ -24,6 +24,8 @@
 
 #include "sink_iface.h"
 
+#include <gnuradio/blocks/rotator_cc.h>
+
 #include <map>
 
 class sink_impl : public osmosdr::sink
@@ -82,8 +84,16 @@ public:
   void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
+  void set_command_time(const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0);
+  void clear_command_time(size_t mboard = 0);
+
 private:
+  void update_lo_offset( size_t dev );
+
   std::vector< sink_iface * > _devs;
+  /* mixers moving the stream to -lo_offset, empty for devices without */
+  std::vector< double > _lo_offsets;
+  std::vector< std::vector< gr::blocks::rotator_cc::sptr > > _ncos;
 
   /* cache to prevent multiple device calls with the same value coming from grc */
   double _sample_rate;
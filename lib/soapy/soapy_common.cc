@@ -19,6 +19,10 @@
  */
 
 #include "soapy_common.h"
+
+#include <algorithm>
+#include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 
 osmosdr::gain_range_t soapy_range_to_gain_range(const SoapySDR::Range &r)
@@ -41,3 +45,40 @@ std::mutex &get_soapy_maker_mutex(void)
     static std::mutex m;
     return m;
 }
+
+std::string soapy_select_stream_format(SoapySDR::Device *device,
+                                       const int direction,
+                                       const std::string &requested,
+                                       double &fullScale)
+{
+    double nativeScale = 0.0;
+    const std::string native = device->getNativeStreamFormat(direction, 0, nativeScale);
+
+    std::string format = requested;
+    if (format.empty() || format == "native") format = native;
+
+    fullScale = 1.0;
+
+    //only the integer formats we have volk kernels for are kept
+    if (format != SOAPY_SDR_CS16 && format != SOAPY_SDR_CS8)
+        return SOAPY_SDR_CF32;
+
+    //fall back to the drivers own conversion if it can't do the format
+    std::vector<std::string> formats = device->getStreamFormats(direction, 0);
+    if (std::find(formats.begin(), formats.end(), format) == formats.end())
+        return SOAPY_SDR_CF32;
+
+    //the reported full scale only applies to the native format,
+    //assume the whole integer range otherwise
+    if (format == native && nativeScale > 0.0)
+        fullScale = nativeScale;
+    else
+        fullScale = (format == SOAPY_SDR_CS8) ? 128.0 : 32768.0;
+
+    return format;
+}
+
+size_t soapy_format_size(const std::string &format)
+{
+    return SoapySDR::formatToSize(format);
+}
@@ -25,6 +25,12 @@
 #include <SoapySDR/Types.hpp>
 
 #include <mutex>
+#include <string>
+
+namespace SoapySDR
+{
+    class Device;
+}
 
 /*!
  * Convert a soapy range to a gain range.
@@ -38,4 +44,21 @@ osmosdr::gain_range_t soapy_range_to_gain_range(const SoapySDR::Range &r);
  */
 std::mutex &get_soapy_maker_mutex(void);
 
+/*!
+ * Select the stream format used between the driver and gr-osmosdr.
+ * "native" asks the driver for its native format and keeps it when it is
+ * CS8 or CS16, so the conversion to/from CF32 happens here with volk.
+ * Any other request (or an unsupported native format) yields "CF32".
+ * \param fullScale set to the full scale value of the selected format
+ */
+std::string soapy_select_stream_format(SoapySDR::Device *device,
+                                       const int direction,
+                                       const std::string &requested,
+                                       double &fullScale);
+
+/*!
+ * Size in bytes of one complex sample in the given stream format.
+ */
+size_t soapy_format_size(const std::string &format);
+
 #endif /* INCLUDED_SOAPY_COMMON_H */
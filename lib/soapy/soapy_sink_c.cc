@@ -37,10 +37,13 @@
 
 #include <gnuradio/io_signature.h>
 
+#include <volk/volk.h>
+
 #include "arg_helpers.h"
 #include "soapy_sink_c.h"
 #include "soapy_common.h"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 
 using namespace boost::assign;
@@ -62,19 +65,46 @@ soapy_sink_c::soapy_sink_c (const std::string &args)
                     args_to_io_signature(args),
                     gr::io_signature::make (0, 0, 0))
 {
+    dict_t dict = params_to_dict(args);
+
+    std::string format = "native";
+    if (dict.count("format"))
+    {
+        format = dict["format"];
+        dict.erase("format");
+    }
+
     {
         std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
-        _device = SoapySDR::Device::make(params_to_dict(args));
+        _device = SoapySDR::Device::make(dict);
     }
     _nchan = std::max(1, args_to_io_signature(args)->max_streams());
     std::vector<size_t> channels;
     for (size_t i = 0; i < _nchan; i++) channels.push_back(i);
-    _stream = _device->setupStream(SOAPY_SDR_TX, "CF32", channels);
+
+    _format = soapy_select_stream_format(_device, SOAPY_SDR_TX, format, _full_scale);
+    _stream = _device->setupStream(SOAPY_SDR_TX, _format, channels);
+
+    //integer formats are converted in work() into intermediate buffers
+    _buf_items = 0;
+    if (_format != SOAPY_SDR_CF32)
+    {
+        _buf_items = _device->getStreamMTU(_stream);
+        const size_t alignment = volk_get_alignment();
+        for (size_t i = 0; i < _nchan; i++)
+            _bufs.push_back(volk_malloc(_buf_items*soapy_format_size(_format), alignment));
+    }
+
+    std::cerr << "Using " << _format << " stream format";
+    if (_format != SOAPY_SDR_CF32)
+        std::cerr << " (full scale " << _full_scale << ")";
+    std::cerr << std::endl;
 }
 
 soapy_sink_c::~soapy_sink_c(void)
 {
     _device->closeStream(_stream);
+    for (void *buf : _bufs) volk_free(buf);
     std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
     SoapySDR::Device::unmake(_device);
 }
@@ -95,9 +125,35 @@ int soapy_sink_c::work( int noutput_items,
 {
     int flags = 0;
     long long timeNs = 0;
+
+    //the driver reads straight from the input buffers
+    if (_bufs.empty())
+    {
+        int ret = _device->writeStream(
+            _stream, &input_items[0],
+            noutput_items, flags, timeNs);
+
+        if (ret < 0) return 0; //call again
+        return ret;
+    }
+
+    const size_t nitems = std::min<size_t>(noutput_items, _buf_items);
+
+    //input is gr_complex (2x float), so num_points is 2*nitems
+    for (size_t i = 0; i < _nchan; i++)
+    {
+        const float *in = reinterpret_cast<const float *>(input_items[i]);
+        if (_format == SOAPY_SDR_CS8)
+            volk_32f_s32f_convert_8i(reinterpret_cast<int8_t *>(_bufs[i]), in,
+                                     _full_scale - 1, 2*nitems);
+        else
+            volk_32f_s32f_convert_16i(reinterpret_cast<int16_t *>(_bufs[i]), in,
+                                      _full_scale - 1, 2*nitems);
+    }
+
     int ret = _device->writeStream(
-        _stream, &input_items[0],
-        noutput_items, flags, timeNs);
+        _stream, &_bufs[0],
+        nitems, flags, timeNs);
 
     if (ret < 0) return 0; //call again
     return ret;
@@ -133,6 +133,10 @@ private:
     SoapySDR::Device *_device;
     SoapySDR::Stream *_stream;
     size_t _nchan;
+    std::string _format;
+    double _full_scale;
+    std::vector<void *> _bufs;
+    size_t _buf_items;
 };
 
 #endif /* INCLUDED_SOAPY_SINK_C_H */
@@ -37,11 +37,14 @@
 
 #include <gnuradio/io_signature.h>
 
+#include <volk/volk.h>
+
 #include "arg_helpers.h"
 #include "soapy_source_c.h"
 #include "soapy_common.h"
 #include "osmosdr/source.h"
 #include <SoapySDR/Device.hpp>
+#include <SoapySDR/Formats.hpp>
 #include <SoapySDR/Version.hpp>
 
 using namespace boost::assign;
@@ -63,19 +66,46 @@ soapy_source_c::soapy_source_c (const std::string &args)
                     gr::io_signature::make (0, 0, 0),
                     args_to_io_signature(args))
 {
+    dict_t dict = params_to_dict(args);
+
+    std::string format = "native";
+    if (dict.count("format"))
+    {
+        format = dict["format"];
+        dict.erase("format");
+    }
+
     {
         std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
-        _device = SoapySDR::Device::make(params_to_dict(args));
+        _device = SoapySDR::Device::make(dict);
     }
     _nchan = std::max(1, args_to_io_signature(args)->max_streams());
     std::vector<size_t> channels;
     for (size_t i = 0; i < _nchan; i++) channels.push_back(i);
-    _stream = _device->setupStream(SOAPY_SDR_RX, "CF32", channels);
+
+    _format = soapy_select_stream_format(_device, SOAPY_SDR_RX, format, _full_scale);
+    _stream = _device->setupStream(SOAPY_SDR_RX, _format, channels);
+
+    //integer formats are read into intermediate buffers and converted in work()
+    _buf_items = 0;
+    if (_format != SOAPY_SDR_CF32)
+    {
+        _buf_items = _device->getStreamMTU(_stream);
+        const size_t alignment = volk_get_alignment();
+        for (size_t i = 0; i < _nchan; i++)
+            _bufs.push_back(volk_malloc(_buf_items*soapy_format_size(_format), alignment));
+    }
+
+    std::cerr << "Using " << _format << " stream format";
+    if (_format != SOAPY_SDR_CF32)
+        std::cerr << " (full scale " << _full_scale << ")";
+    std::cerr << std::endl;
 }
 
 soapy_source_c::~soapy_source_c(void)
 {
     _device->closeStream(_stream);
+    for (void *buf : _bufs) volk_free(buf);
     std::lock_guard<std::mutex> l(get_soapy_maker_mutex());
     SoapySDR::Device::unmake(_device);
 }
@@ -99,13 +129,41 @@ int soapy_source_c::work( int noutput_items,
     int ret;
     int retries = 1;
 
+    //the driver writes straight into the output buffers
+    if (_bufs.empty())
+    {
+        do {
+            ret = _device->readStream(
+                _stream, &output_items[0],
+                noutput_items, flags, timeNs);
+        } while (retries-- && (ret == SOAPY_SDR_OVERFLOW));
+
+        if (ret < 0) return 0; //call again
+        return ret;
+    }
+
+    const size_t nitems = std::min<size_t>(noutput_items, _buf_items);
+
     do {
         ret = _device->readStream(
-            _stream, &output_items[0],
-            noutput_items, flags, timeNs);
+            _stream, &_bufs[0],
+            nitems, flags, timeNs);
     } while (retries-- && (ret == SOAPY_SDR_OVERFLOW));
 
-    if (ret < 0) return 0; //call again
+    if (ret <= 0) return 0; //call again
+
+    //output is gr_complex (2x float), so num_points is 2*ret
+    for (size_t i = 0; i < _nchan; i++)
+    {
+        float *out = reinterpret_cast<float *>(output_items[i]);
+        if (_format == SOAPY_SDR_CS8)
+            volk_8i_s32f_convert_32f(out, reinterpret_cast<const int8_t *>(_bufs[i]),
+                                     _full_scale, 2*ret);
+        else
+            volk_16i_s32f_convert_32f(out, reinterpret_cast<const int16_t *>(_bufs[i]),
+                                      _full_scale, 2*ret);
+    }
+
     return ret;
 }
 
@@ -287,6 +345,12 @@ std::string soapy_source_c::get_antenna( size_t chan )
     return _device->getAntenna(SOAPY_SDR_RX, chan);
 }
 
+bool soapy_source_c::has_dc_offset_correction( size_t chan )
+{
+    return _device->hasDCOffsetMode(SOAPY_SDR_RX, chan) ||
+           _device->hasDCOffset(SOAPY_SDR_RX, chan);
+}
+
 void soapy_source_c::set_dc_offset_mode( int mode, size_t chan )
 {
     switch (mode)
@@ -309,6 +373,11 @@ void soapy_source_c::set_dc_offset( const std::complex<double> &offset, size_t c
     _device->setDCOffset(SOAPY_SDR_RX, chan, offset);
 }
 
+bool soapy_source_c::has_iq_balance_correction( size_t chan )
+{
+    return _device->hasIQBalance(SOAPY_SDR_RX, chan);
+}
+
 void soapy_source_c::set_iq_balance_mode( int mode, size_t chan )
 {
     if (mode == osmosdr::source::IQBalanceOff) return; //no error on disable
@@ -107,8 +107,10 @@ std::vector< std::string > get_antennas( size_t chan );
 std::string set_antenna( const std::string & antenna,
                                    size_t chan );
 std::string get_antenna( size_t chan );
+bool has_dc_offset_correction( size_t chan );
 void set_dc_offset_mode( int mode, size_t chan );
 void set_dc_offset( const std::complex<double> &offset, size_t chan );
+bool has_iq_balance_correction( size_t chan );
 void set_iq_balance_mode( int mode, size_t chan );
 void set_iq_balance( const std::complex<double> &balance, size_t chan );
 double set_bandwidth( double bandwidth, size_t chan );
@@ -135,6 +137,10 @@ private:
     SoapySDR::Device *_device;
     SoapySDR::Stream *_stream;
     size_t _nchan;
+    std::string _format;
+    double _full_scale;
+    std::vector<void *> _bufs;
+    size_t _buf_items;
 };
 
 #endif /* INCLUDED_SOAPY_SOURCE_C_H */
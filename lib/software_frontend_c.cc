@@ -0,0 +1,424 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+#ifdef USE_AVX
+#include <immintrin.h>
+#elif USE_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+#include "software_frontend_c.h"
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+static const pmt::pmt_t AGC_KEY = pmt::string_to_symbol("rx_agc");
+
+software_frontend_c_sptr make_software_frontend_c( source_iface *dev, size_t nchan )
+{
+  return gnuradio::get_initial_sptr( new software_frontend_c( dev, nchan ) );
+}
+
+software_frontend_c::software_frontend_c( source_iface *dev, size_t nchan )
+  : gr::sync_block( "software_frontend_c",
+                    gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ),
+                    gr::io_signature::make( nchan, nchan, sizeof(gr_complex) ) ),
+    _dev( dev ),
+    _has_cmd_time( false ),
+    _emulate_cmd_time( false ),
+    _reanchor( true ),
+    _rate( 0 ),
+    _anchor_sample( 0 ),
+    _lo_offset( 0 ),
+    _nco_update( false ),
+    _nco( nchan ),
+    _dc( nchan ),
+    _iq( nchan ),
+    _agc( nchan ),
+    _agc_in_device( nchan, false ),
+    _agc_gain( nchan, 1.0f )
+{
+  _id = pmt::string_to_symbol( alias() );
+
+  /* rx_freq tags from the device are corrected for the LO offset */
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+void software_frontend_c::set_sample_rate( double rate )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  _rate = rate;
+  _reanchor = true;
+  _nco_update = true;
+}
+
+void software_frontend_c::set_lo_offset( double offset )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  _lo_offset = offset;
+  _nco_update = true;
+}
+
+double software_frontend_c::get_lo_offset( void )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  return _lo_offset;
+}
+
+void software_frontend_c::set_dc_offset_mode( int mode, size_t chan )
+{
+  _dc.at( chan ).set_mode( mode );
+}
+
+void software_frontend_c::set_dc_offset( const std::complex<double> &offset, size_t chan )
+{
+  _dc.at( chan ).set_offset( offset );
+}
+
+void software_frontend_c::set_iq_balance_mode( int mode, size_t chan )
+{
+  _iq.at( chan ).set_mode( mode );
+}
+
+void software_frontend_c::set_iq_balance( const std::complex<double> &balance, size_t chan )
+{
+  _iq.at( chan ).set_balance( balance );
+}
+
+void software_frontend_c::set_agc( double target, double attack, double decay, size_t chan )
+{
+  _agc.at( chan ).configure( target, attack, decay );
+
+  /* 8 bit devices measure and scale in the integer domain */
+  _agc_in_device[ chan ] = _dev->set_software_agc( &_agc[ chan ], chan );
+}
+
+bool software_frontend_c::set_agc_mode( bool automatic, size_t chan )
+{
+  _agc.at( chan ).set_enabled( automatic );
+
+  return automatic;
+}
+
+bool software_frontend_c::get_agc_mode( size_t chan )
+{
+  return _agc.at( chan ).enabled();
+}
+
+void software_frontend_c::set_command_time( const osmosdr::time_spec_t &time_spec,
+                                            bool emulated )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  _cmd_time = time_spec;
+  _has_cmd_time = true;
+  _emulate_cmd_time = emulated;
+}
+
+void software_frontend_c::clear_command_time( void )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  _has_cmd_time = false;
+}
+
+bool software_frontend_c::has_command_time( void )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  return _has_cmd_time && _emulate_cmd_time;
+}
+
+double software_frontend_c::schedule_center_freq( double freq, size_t chan )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  _retunes.insert( std::make_pair( _cmd_time, std::make_pair( chan, freq ) ) );
+
+  return freq;
+}
+
+void software_frontend_c::tag_center_freq( double freq, size_t chan )
+{
+  if ( _dev->has_retune_tags() )
+    return;
+
+  uint64_t hop = _dev->get_capture_index( chan );
+
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  if ( _has_cmd_time && ! _emulate_cmd_time ) /* the device retunes at that time */
+    _timed_tags.insert( std::make_pair( _cmd_time, std::make_pair( chan, freq ) ) );
+  else /* on the next sample if the device cannot tell */
+    _freq_tags.insert( std::make_pair( hop, std::make_pair( chan, freq ) ) );
+}
+
+void software_frontend_c::request_center_freq( double freq, size_t chan )
+{
+  std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+  /* ahead of any timed retune, so it is due right away */
+  _retunes.insert( std::make_pair( ::osmosdr::time_spec_t(), std::make_pair( chan, freq ) ) );
+}
+
+/*
+ * One pass over a channel: out = M (in - dc), M mapping (I, Q) to
+ * (I, a Q + b I).  Adds in to sum and, if STATS, the sums of I, Q, I^2,
+ * Q^2 and IQ of in - dc to stats.
+ */
+template< bool STATS >
+static void correct( gr_complex *out, const gr_complex *in, int n,
+                     gr_complex dc, float a, float b,
+                     gr_complex &sum, double stats[5] )
+{
+  float s[5] = { 0, 0, 0, 0, 0 };
+  int i = 0;
+
+#if defined(USE_SSE2) || defined(USE_AVX)
+  const __m128 offset = _mm_set_ps( dc.imag(), dc.real(), dc.imag(), dc.real() );
+  const __m128 ma = _mm_set_ps( a, 1.0f, a, 1.0f );
+  const __m128 mb = _mm_set_ps( b, 0.0f, b, 0.0f );
+  __m128 acc = _mm_setzero_ps();
+  __m128 xacc = _mm_setzero_ps(), sq = _mm_setzero_ps(), cross = _mm_setzero_ps();
+  alignas(16) float tmp[4];
+
+  for ( ; i + 2 <= n; i += 2 ) {
+    __m128 v = _mm_loadu_ps( (const float *)&in[i] );
+    __m128 x = _mm_sub_ps( v, offset );
+    /* I of each sample in both lanes */
+    __m128 xi = _mm_shuffle_ps( x, x, _MM_SHUFFLE(2, 2, 0, 0) );
+
+    acc = _mm_add_ps( acc, v );
+
+    if ( STATS ) {
+      xacc = _mm_add_ps( xacc, x );
+      sq = _mm_add_ps( sq, _mm_mul_ps( x, x ) );
+      cross = _mm_add_ps( cross, _mm_mul_ps( x, xi ) );
+    }
+
+    _mm_storeu_ps( (float *)&out[i], _mm_add_ps( _mm_mul_ps( x, ma ),
+                                                 _mm_mul_ps( xi, mb ) ) );
+  }
+
+  _mm_store_ps( tmp, acc );
+  sum += gr_complex( tmp[0] + tmp[2], tmp[1] + tmp[3] );
+
+  if ( STATS ) {
+    _mm_store_ps( tmp, xacc );
+    s[0] = tmp[0] + tmp[2];
+    s[1] = tmp[1] + tmp[3];
+    _mm_store_ps( tmp, sq );
+    s[2] = tmp[0] + tmp[2];
+    s[3] = tmp[1] + tmp[3];
+    _mm_store_ps( tmp, cross );
+    s[4] = tmp[1] + tmp[3];
+  }
+#endif
+
+  for ( ; i < n; i++ ) {
+    gr_complex x = in[i] - dc;
+
+    sum += in[i];
+
+    if ( STATS ) {
+      s[0] += x.real();
+      s[1] += x.imag();
+      s[2] += x.real() * x.real();
+      s[3] += x.imag() * x.imag();
+      s[4] += x.real() * x.imag();
+    }
+
+    out[i] = gr_complex( x.real(), a * x.imag() + b * x.real() );
+  }
+
+  if ( STATS )
+    for ( int k = 0; k < 5; k++ )
+      stats[k] = s[k];
+}
+
+/* must be called with _cmd_mutex held */
+uint64_t software_frontend_c::time_to_sample( const osmosdr::time_spec_t &time_spec )
+{
+  if ( time_spec < _anchor_time || _rate <= 0 )
+    return _anchor_sample;
+
+  double delta = (time_spec - _anchor_time).get_real_secs();
+
+  return _anchor_sample + uint64_t( std::llround( delta * _rate ) );
+}
+
+int software_frontend_c::work( int noutput_items,
+                               gr_vector_const_void_star &input_items,
+                               gr_vector_void_star &output_items )
+{
+  const uint64_t start = nitems_written(0);
+  int nitems = noutput_items;
+
+  /* where a retune issued now takes effect, 0 if the device cannot tell */
+  const uint64_t captured = _dev->get_capture_index();
+
+  std::vector< std::pair< size_t, double > > due;
+  double lo_offset;
+
+  {
+    std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+    if ( _reanchor ) {
+      /* the device is capturing right now what lands at the anchor */
+      _anchor_time = _dev->get_time_now();
+      _anchor_sample = captured ? captured : start + noutput_items;
+      if ( _rate <= 0 )
+        _rate = _dev->get_sample_rate();
+      _reanchor = false;
+
+      for ( dc_tracker &dc : _dc )
+        dc.set_sample_rate( _rate );
+      for ( iq_balance_tracker &iq : _iq )
+        iq.set_sample_rate( _rate );
+      for ( agc_tracker &agc : _agc )
+        agc.set_sample_rate( _rate );
+    }
+
+    if ( _nco_update && _rate > 0 ) {
+      /* the wanted signal sits at -lo_offset, shift it up to DC */
+      gr_complex incr = std::polar( 1.0f, float( 2 * M_PI * _lo_offset / _rate ) );
+      for ( gr::blocks::rotator &nco : _nco )
+        nco.set_phase_incr( incr );
+      _nco_update = false;
+    }
+
+    lo_offset = _lo_offset;
+
+    while ( ! _retunes.empty() ) {
+      uint64_t sample = time_to_sample( _retunes.begin()->first );
+
+      if ( sample > (captured ? captured : start) ) {
+        /* stop right before the retune, it is applied on the next call */
+        if ( ! captured && sample - start < uint64_t(nitems) )
+          nitems = int(sample - start);
+        break;
+      }
+
+      due.push_back( _retunes.begin()->second );
+      _retunes.erase( _retunes.begin() );
+    }
+
+    for ( const auto &tag : _timed_tags )
+      _freq_tags.insert( std::make_pair( time_to_sample( tag.first ), tag.second ) );
+    _timed_tags.clear();
+  }
+
+  for ( const std::pair< size_t, double > &retune : due ) {
+    double freq = _dev->set_center_freq( retune.second, retune.first );
+    tag_center_freq( freq, retune.first );
+  }
+
+  std::vector< gr::tag_t > tags;
+
+  for ( size_t i = 0; i < output_items.size(); i++ ) {
+    get_tags_in_range( tags, i, nitems_read(i), nitems_read(i) + nitems );
+
+    for ( gr::tag_t tag : tags ) {
+      if ( pmt::eq( tag.key, FREQ_KEY ) && pmt::is_number( tag.value ) )
+        tag.value = pmt::from_double( pmt::to_double( tag.value ) - lo_offset );
+      add_item_tag( i, tag );
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock( _cmd_mutex );
+
+    /* retunes of earlier calls may take effect further down the stream */
+    auto end = _freq_tags.lower_bound( start + nitems );
+
+    for ( auto tag = _freq_tags.begin(); tag != end; ++tag )
+      add_item_tag( tag->second.first, std::max( tag->first, start ), FREQ_KEY,
+                    pmt::from_double( tag->second.second - lo_offset ), _id );
+
+    _freq_tags.erase( _freq_tags.begin(), end );
+  }
+
+  for ( size_t i = 0; i < output_items.size(); i++ ) {
+    gr_complex *out = (gr_complex *)output_items[i];
+    const gr_complex *in = (const gr_complex *)input_items[i];
+
+    bool fix_dc = _dc[i].enabled();
+    gr_complex dc = fix_dc ? gr_complex( _dc[i].offset() ) : gr_complex( 0, 0 );
+    float a = 1.0f, b = 0.0f;
+    bool fix_iq = _iq[i].correction( a, b );
+    int nstats = _iq[i].stats_len( nitems );
+
+    if ( fix_dc || fix_iq || nstats ) {
+      gr_complex sum( 0, 0 );
+      double stats[5];
+
+      /* moments on a short window at the start, the rest without */
+      correct< true >( out, in, nstats, dc, a, b, sum, stats );
+      correct< false >( out + nstats, in + nstats, nitems - nstats, dc, a, b, sum, stats );
+
+      _dc[i].update( std::complex<double>( sum ), nitems );
+      if ( nstats )
+        _iq[i].update( stats, nstats );
+
+      in = out;
+    }
+
+    if ( 0 != lo_offset )
+      _nco[i].rotateN( out, in, nitems );
+    else if ( in != out )
+      memcpy( out, in, nitems * sizeof(gr_complex) );
+
+    if ( _agc_in_device[i] )
+      continue;
+
+    /* measured first, so a burst is caught by the call it starts in */
+    if ( _agc[i].enabled() ) {
+      lv_32fc_t power;
+      volk_32fc_x2_conjugate_dot_prod_32fc( &power, out, out, nitems );
+      _agc[i].update( power.real(), nitems );
+    }
+
+    /* the gain holds over the whole call, changes are tagged */
+    float gain = _agc[i].gain();
+
+    if ( gain != _agc_gain[i] ) {
+      add_item_tag( i, start, AGC_KEY, pmt::from_double( gain ), _id );
+      _agc_gain[i] = gain;
+    }
+
+    if ( 1.0f != gain )
+      volk_32f_s32f_multiply_32f( (float *)out, (const float *)out, gain, 2 * nitems );
+  }
+
+  return nitems;
+}
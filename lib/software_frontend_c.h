@@ -0,0 +1,158 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_SOFTWARE_FRONTEND_C_H
+#define INCLUDED_SOFTWARE_FRONTEND_C_H
+
+#include <gnuradio/sync_block.h>
+#include <gnuradio/blocks/rotator.h>
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "source_iface.h"
+#include "dc_tracker.h"
+#include "iq_balance_tracker.h"
+#include "agc_tracker.h"
+
+class software_frontend_c;
+
+typedef std::shared_ptr< software_frontend_c > software_frontend_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of software_frontend_c.
+ *
+ * \param dev the device whose channels pass through this block
+ * \param nchan number of channels of the device
+ */
+software_frontend_c_sptr make_software_frontend_c( source_iface *dev, size_t nchan );
+
+/*!
+ * \brief Software emulation of frontend features for one source device.
+ *
+ * Sits between a device block and the outputs of source_impl and passes
+ * all channels of the device through in lock-step. Features the device
+ * lacks in hardware are implemented here:
+ *
+ *  - timed commands: retunes issued while a command time is set are held
+ *    back until the device has captured the sample corresponding to that
+ *    time, then applied. Devices reporting get_capture_index() are retuned
+ *    ahead of the stream by what they still have buffered, and the rx_freq
+ *    tag goes on the first sample they capture after the retune. For other
+ *    devices the retune is applied once the stream reaches the sample and
+ *    the tag is approximate: samples still buffered in the driver were
+ *    taken at the old frequency but follow the tag.
+ *  - retune tags: retunes the caller applies directly are tagged the same
+ *    way, so blocks behind it see every change of the center frequency.
+ *  - LO offset: the device is tuned lo_offset above the requested center
+ *    and the stream is mixed back while it is copied, which moves the DC
+ *    spike of zero-IF tuners out of the way. rx_freq tags are corrected
+ *    to the requested center.
+ *  - DC offset removal and IQ imbalance correction: a per channel
+ *    estimate of the mean is subtracted and Q is rebalanced against I in
+ *    the same pass that copies the stream, before the LO offset mix.
+ *  - AGC: a per channel gain scales the stream towards a target level and
+ *    every change is marked with an rx_agc tag.  Devices delivering 8 bit
+ *    samples may run it on their raw samples instead.
+ */
+class software_frontend_c : public gr::sync_block
+{
+private:
+  friend software_frontend_c_sptr make_software_frontend_c( source_iface *dev,
+                                                            size_t nchan );
+
+  software_frontend_c( source_iface *dev, size_t nchan );
+
+public:
+  int work( int noutput_items,
+            gr_vector_const_void_star &input_items,
+            gr_vector_void_star &output_items );
+
+  /* notify about a new device rate, the stream time is re-anchored */
+  void set_sample_rate( double rate );
+
+  /* emulated is false if the device executes timed commands itself */
+  void set_command_time( const ::osmosdr::time_spec_t &time_spec, bool emulated );
+  void clear_command_time( void );
+  bool has_command_time( void ); /* an emulated one */
+
+  /* queue a retune for the current command time, returns freq */
+  double schedule_center_freq( double freq, size_t chan );
+
+  /* the caller has retuned the device to freq, tag where it takes effect */
+  void tag_center_freq( double freq, size_t chan );
+
+  /* retune from another streaming thread, applied on the next call */
+  void request_center_freq( double freq, size_t chan );
+
+  /* distance of the device LO above the center of the outputs */
+  void set_lo_offset( double offset );
+  double get_lo_offset( void );
+
+  /* software DC offset correction, offsets are in full scale units */
+  void set_dc_offset_mode( int mode, size_t chan );
+  void set_dc_offset( const std::complex<double> &offset, size_t chan );
+
+  /* software IQ balance correction, see iq_balance_tracker */
+  void set_iq_balance_mode( int mode, size_t chan );
+  void set_iq_balance( const std::complex<double> &balance, size_t chan );
+
+  /* software AGC, target in dBFS, attack and decay in seconds */
+  void set_agc( double target, double attack, double decay, size_t chan );
+  bool set_agc_mode( bool automatic, size_t chan );
+  bool get_agc_mode( size_t chan );
+
+private:
+  uint64_t time_to_sample( const ::osmosdr::time_spec_t &time_spec );
+
+  source_iface *_dev;
+  pmt::pmt_t _id;
+
+  std::mutex _cmd_mutex;
+  bool _has_cmd_time;
+  bool _emulate_cmd_time;
+  ::osmosdr::time_spec_t _cmd_time;
+  std::multimap< ::osmosdr::time_spec_t, std::pair< size_t, double > > _retunes;
+
+  /* rx_freq tags to add, by device time or by stream index */
+  std::multimap< ::osmosdr::time_spec_t, std::pair< size_t, double > > _timed_tags;
+  std::multimap< uint64_t, std::pair< size_t, double > > _freq_tags;
+
+  /* relation between stream samples and device time */
+  bool _reanchor;
+  double _rate;
+  uint64_t _anchor_sample;
+  ::osmosdr::time_spec_t _anchor_time;
+
+  double _lo_offset;
+  bool _nco_update;
+  std::vector< gr::blocks::rotator > _nco;
+
+  std::vector< dc_tracker > _dc;
+  std::vector< iq_balance_tracker > _iq;
+
+  std::vector< agc_tracker > _agc;
+  std::vector< bool > _agc_in_device;
+  std::vector< float > _agc_gain; /* last one tagged */
+};
+
+#endif /* INCLUDED_SOFTWARE_FRONTEND_C_H */
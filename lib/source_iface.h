@@ -25,6 +25,8 @@
 #include <osmosdr/time_spec.h>
 #include <gnuradio/basic_block.h>
 
+class agc_tracker;
+
 /*!
  * TODO: document
  *
@@ -50,6 +52,24 @@ public:
    */
   virtual bool seek( long seek_point, int whence, size_t chan = 0 ) { return false; }
 
+  /*!
+   * \brief seek file to the sample recorded at \p time
+   *
+   * \param time	absolute time of the sample to seek to
+   * \param chan	the channel index 0 to N-1
+   * \return true on success
+   */
+  virtual bool seek_time( const osmosdr::time_spec_t &time, size_t chan = 0 ) { return false; }
+
+  /*!
+   * \brief seek file to the first sample of capture segment \p segment
+   *
+   * \param segment	the segment index 0 to N-1
+   * \param chan	the channel index 0 to N-1
+   * \return true on success
+   */
+  virtual bool seek_segment( size_t segment, size_t chan = 0 ) { return false; }
+
   /*!
    * Get the possible sample rates for the underlying radio hardware.
    * \return a range of rates in Sps
@@ -148,6 +168,16 @@ public:
    */
   virtual bool get_gain_mode( size_t chan = 0 ) { return false; }
 
+  /*!
+   * Let the device run the software AGC of a channel on its raw samples,
+   * where power and gain are cheaper to handle. The device applies the
+   * gain and marks each change with an rx_agc tag.
+   * \param agc the AGC state, owned by the source
+   * \param chan the channel index 0 to N-1
+   * \return false if the device leaves the AGC to the source
+   */
+  virtual bool set_software_agc( agc_tracker *agc, size_t chan = 0 ) { return false; }
+
   /*!
    * Set the gain for the underlying radio hardware.
    * This function will automatically distribute the desired gain value over
@@ -227,6 +257,13 @@ public:
    */
   virtual std::string get_antenna( size_t chan = 0 ) = 0;
 
+  /*!
+   * Whether the device handles the DC offset settings below itself.
+   * Otherwise the source removes the DC offset in software.
+   * \param chan the channel index 0 to N-1
+   */
+  virtual bool has_dc_offset_correction( size_t chan = 0 ) { return false; }
+
   /*!
    * Set the RX frontend DC correction mode.
    * The automatic correction subtracts out the long-run average.
@@ -251,6 +288,13 @@ public:
    */
   virtual void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 ) { }
 
+  /*!
+   * Whether the device handles the IQ balance settings below itself.
+   * Otherwise the source corrects the IQ imbalance in software.
+   * \param chan the channel index 0 to N-1
+   */
+  virtual bool has_iq_balance_correction( size_t chan = 0 ) { return false; }
+
   /*!
    * Set the RX frontend IQ balance mode.
    *
@@ -291,6 +335,17 @@ public:
   virtual osmosdr::freq_range_t get_bandwidth_range( size_t chan = 0 )
     { return osmosdr::freq_range_t(); }
 
+  /*!
+   * Let the device hop through equally spaced frequencies by itself
+   * once streaming starts. The first sample of every hop carries an
+   * rx_freq tag with the frequency of the hop.
+   * \param freqs the center frequencies of the hops in Hz
+   * \param dwell the minimum number of samples to stay on each hop
+   * \return false if the device has no native sweep mode
+   */
+  virtual bool set_sweep( const std::vector< double > &freqs, size_t dwell )
+    { return false; }
+
   /*!
    * Set the time source for the device.
    * This sets the method of time synchronization,
@@ -399,6 +454,44 @@ public:
    * \param time_spec the new time
    */
   virtual void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec) { }
+
+  /*!
+   * Whether set_command_time() is executed by the device itself.
+   * Otherwise the source emulates timed commands in software.
+   */
+  virtual bool has_timed_commands( void ) { return false; }
+
+  /*!
+   * Get the stream index of the next sample the device is going to
+   * capture, counting output samples from the start of streaming.
+   * Samples still on their way from the hardware count as captured.
+   * The source uses it to put the rx_freq tag of a retune on the first
+   * sample taken at the new frequency.
+   * \param chan the channel index 0 to N-1
+   * \return the stream index or 0 if the device cannot tell
+   */
+  virtual uint64_t get_capture_index( size_t chan = 0 ) { return 0; }
+
+  /*!
+   * Whether the device marks the first sample after a retune with an
+   * rx_freq tag itself. Otherwise the source adds the tag.
+   */
+  virtual bool has_retune_tags( void ) { return false; }
+
+  /*!
+   * Set the time at which subsequent commands take effect.
+   * \param time_spec the time at which the commands take effect
+   * \param mboard the motherboard index 0 to M-1
+   * \return true if the device executes timed commands itself
+   */
+  virtual bool set_command_time(const ::osmosdr::time_spec_t &time_spec,
+                                size_t mboard = 0) { return false; }
+
+  /*!
+   * Clear the command time so subsequent commands take effect immediately.
+   * \param mboard the motherboard index 0 to M-1
+   */
+  virtual void clear_command_time(size_t mboard = 0) { }
 };
 
 #endif // OSMOSDR_SOURCE_IFACE_H
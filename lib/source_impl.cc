@@ -97,8 +97,17 @@
 #endif
 
 #include "arg_helpers.h"
+#include "software_frontend_c.h"
+#include "squelch_c.h"
+#include "resampler_c.h"
+#include "channelizer_c.h"
+#include "spectrum_c.h"
+#include "sweep_c.h"
 #include "source_impl.h"
 
+/* samples discarded after the device hopped by itself, half a HackRF sweep block */
+#define NATIVE_SWEEP_SETTLE 4096
+
 /*
  * Create a new instance of source_impl and return
  * a boost shared_ptr.  This is effectively the public constructor.
@@ -115,11 +124,14 @@ osmosdr::source::make( const std::string &args )
 source_impl::source_impl( const std::string &args )
   : gr::hier_block2 ("source_impl",
         gr::io_signature::make(0, 0, 0),
-        args_to_io_signature(args)),
+        args_to_io_signature(args, true)),
     _sample_rate(NAN)
 {
   size_t channel = 0;
   bool device_specified = false;
+  std::vector< std::pair< channelizer_c_sptr, size_t > > subchannel_outputs;
+  std::vector< spectrum_c_sptr > spectrum_outputs;
+  std::vector< sweep_c_sptr > sweep_outputs;
 
   std::vector< std::string > arg_list = args_to_vector(args);
 
@@ -399,23 +411,182 @@ source_impl::source_impl( const std::string &args )
     if (iface != NULL && reinterpret_cast<std::intptr_t>(block.get()) != 0 ) {
       _devs.push_back( iface );
 
+      /* uhd offsets its LO by itself */
+      bool lo_offset = dict.count("lo_offset") && ! dict.count("uhd");
+
+      /* software emulation of what the device lacks, left out if nothing is */
+      bool emulate = ! iface->has_timed_commands() || lo_offset ||
+                     dict.count("channelize") || dict.count("sweep") || dict.count("agc");
+
+      /* gr-iqbalance instead of the built-in IQ balance corrector */
+      bool gr_iqbal = dict.count("iqbal") && "gr" == dict["iqbal"];
+#ifndef HAVE_IQBALANCE
+      if ( gr_iqbal )
+        throw std::runtime_error("iqbal=gr requires gr-osmosdr to be built with gr-iqbalance.");
+#endif
+
       for (size_t i = 0; i < iface->get_num_channels(); i++) {
+        emulate = emulate || ! iface->has_dc_offset_correction( i );
+        /* unless gr-iqbalance takes care of it, see below */
+        emulate = emulate || ( ! gr_iqbal && ! iface->has_iq_balance_correction( i ) );
+      }
+
+      software_frontend_c_sptr frontend;
+      gr::basic_block_sptr head = block;
+
+      if ( emulate ) {
+        frontend = make_software_frontend_c( iface, iface->get_num_channels() );
+        head = frontend;
+
+        if ( lo_offset )
+          frontend->set_lo_offset( boost::lexical_cast<double>( dict["lo_offset"] ) );
+      }
+
+      _frontends.push_back( frontend.get() );
+
+      /* deliver any requested rate from the nearest one of the device */
+      resampler_c_sptr resampler;
+      gr::basic_block_sptr tail = head;
+
+      if ( dict.count("resample") && boost::lexical_cast<bool>( dict["resample"] ) ) {
+        resampler = make_resampler_c( iface->get_num_channels() );
+        resampler->set_rates( iface->get_sample_rate(), iface->get_sample_rate() );
+        tail = resampler;
+      }
+
+      _resamplers.push_back( resampler.get() );
+
+      /* sub-channels of the first device channel, connected below */
+      channelizer_c_sptr channelizer;
+
+      if ( dict.count("channelize") ) {
+        std::vector< subchannel_t > subchannels = params_to_subchannels( dict["channelize"] );
+
+        channelizer = make_channelizer_c( subchannels, iface->get_sample_rate(),
+                                          iface->get_center_freq( 0 ) -
+                                          frontend->get_lo_offset() );
+        connect(head, 0, channelizer, 0);
+
+        for (size_t i = 0; i < subchannels.size(); i++)
+          subchannel_outputs.push_back( std::make_pair( channelizer, i ) );
+      }
+
+      _channelizers.push_back( channelizer.get() );
+
+      /* optionally drop the silence between bursts, per channel */
+      std::vector< squelch_c * > squelches;
+
+      for (size_t i = 0; i < iface->get_num_channels(); i++) {
+        if ( frontend )
+          connect(block, i, frontend, i);
+        if ( resampler )
+          connect(head, i, resampler, i);
+
+        gr::basic_block_sptr out = tail;
+        int out_port = i;
 #ifdef HAVE_IQBALANCE
-        gr::iqbalance::optimize_c::sptr iq_opt = gr::iqbalance::optimize_c::make( 0 );
-        gr::iqbalance::fix_cc::sptr     iq_fix = gr::iqbalance::fix_cc::make();
+        gr::iqbalance::optimize_c::sptr iq_opt;
+        gr::iqbalance::fix_cc::sptr     iq_fix;
 
-        connect(block, i, iq_fix, 0);
-        connect(iq_fix, 0, self(), channel++);
+        if ( gr_iqbal && ! iface->has_iq_balance_correction( i ) ) {
+          iq_opt = gr::iqbalance::optimize_c::make( 0 );
+          iq_fix = gr::iqbalance::fix_cc::make();
 
-        connect(block, i, iq_opt, 0);
-        msg_connect(iq_opt, "iqbal_corr", iq_fix, "iqbal_corr");
+          connect(tail, i, iq_fix, 0);
+
+          connect(tail, i, iq_opt, 0);
+          msg_connect(iq_opt, "iqbal_corr", iq_fix, "iqbal_corr");
+
+          out = iq_fix;
+          out_port = 0;
+        }
 
         _iq_opt.push_back( iq_opt.get() );
         _iq_fix.push_back( iq_fix.get() );
-#else
-        connect(block, i, self(), channel++);
 #endif
+
+        if ( dict.count("squelch") ) {
+          double guard = 0.01;
+          if ( dict.count("squelch_guard") )
+            guard = boost::lexical_cast< double >( dict["squelch_guard"] );
+
+          squelch_c_sptr squelch =
+              make_squelch_c( iface, boost::lexical_cast< double >( dict["squelch"] ),
+                              guard, iface->get_sample_rate() );
+          connect(out, out_port, squelch, 0);
+          connect(squelch, 0, self(), channel++);
+          squelches.push_back( squelch.get() );
+        } else {
+          connect(out, out_port, self(), channel++);
+        }
       }
+
+      _squelches.push_back( squelches );
+
+      /* power spectrum of the first device channel, connected below */
+      spectrum_c_sptr spectrum;
+
+      if ( dict.count("spectrum") ) {
+        double update_rate = 10;
+        if ( dict.count("spectrum_rate") )
+          update_rate = boost::lexical_cast< double >( dict["spectrum_rate"] );
+
+        double alpha = 0.25;
+        if ( dict.count("spectrum_alpha") )
+          alpha = boost::lexical_cast< double >( dict["spectrum_alpha"] );
+
+        spectrum = make_spectrum_c( boost::lexical_cast< size_t >( dict["spectrum"] ),
+                                    iface->get_sample_rate(), update_rate, alpha );
+        connect(tail, 0, spectrum, 0);
+        spectrum_outputs.push_back( spectrum );
+      }
+
+      _spectra.push_back( spectrum.get() );
+
+      /* frequency sweep of the first device channel, connected below */
+      sweep_c_sptr sweep;
+
+      if ( dict.count("sweep") ) {
+        std::vector< double > freqs = params_to_sweep( dict["sweep"] );
+
+        size_t dwell = 0;
+        if ( dict.count("sweep_dwell") )
+          dwell = boost::lexical_cast< size_t >( dict["sweep_dwell"] );
+
+        /* devices hopping by themselves still need their PLL to lock, like
+           hackrf_sweep only the tail of each hop is measured, so the
+           settling time is added to the time the device stays on a hop */
+        size_t settle = dict.count("sweep_settle") ?
+                          boost::lexical_cast< size_t >( dict["sweep_settle"] ) :
+                          NATIVE_SWEEP_SETTLE;
+        bool native = iface->set_sweep( freqs, settle + dwell );
+
+        if ( !native && !dict.count("sweep_settle") )
+          settle = 65536;
+
+        sweep = make_sweep_c( native ? NULL : frontend.get(), freqs,
+                              dict_to_sweep_bins( dict ), dwell, settle,
+                              iface->get_sample_rate() );
+        connect(tail, 0, sweep, 0);
+        sweep_outputs.push_back( sweep );
+      }
+
+      _sweeps.push_back( sweep.get() );
+
+      /* software AGC, switched by set_gain_mode() instead of the hardware one */
+      if ( dict.count("agc") ) {
+        double attack = 0.001, decay = 0.1;
+        if ( dict.count("agc_attack") )
+          attack = boost::lexical_cast< double >( dict["agc_attack"] );
+        if ( dict.count("agc_decay") )
+          decay = boost::lexical_cast< double >( dict["agc_decay"] );
+
+        for (size_t i = 0; i < iface->get_num_channels(); i++)
+          frontend->set_agc( boost::lexical_cast< double >( dict["agc"] ),
+                             attack, decay, i );
+      }
+
+      _agc.push_back( dict.count("agc") > 0 );
     } else if ((iface != NULL) || (reinterpret_cast<std::intptr_t>(block.get()) != 0))
       throw std::runtime_error("Either iface or block are NULL.");
 
@@ -424,6 +595,20 @@ source_impl::source_impl( const std::string &args )
   if (!_devs.size())
     throw std::runtime_error("No devices specified via device arguments.");
 
+  /* sub-channel outputs follow the channels of all devices */
+  for (const std::pair< channelizer_c_sptr, size_t > &output : subchannel_outputs) {
+    connect(output.first, output.second, self(), channel++);
+    _subchannels.push_back( std::make_pair( output.first.get(), output.second ) );
+  }
+
+  /* followed by the spectrum outputs */
+  for (const spectrum_c_sptr &spectrum : spectrum_outputs)
+    connect(spectrum, 0, self(), channel++);
+
+  /* and the sweep outputs */
+  for (const sweep_c_sptr &sweep : sweep_outputs)
+    connect(sweep, 0, self(), channel++);
+
   /* Populate the _gain and _gain_mode arrays with the hardware state */
   for ( source_iface *dev : _devs )
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
@@ -442,6 +627,16 @@ size_t source_impl::get_num_channels()
   return channels;
 }
 
+const std::pair< channelizer_c *, size_t > *source_impl::get_subchannel( size_t chan )
+{
+  size_t channels = get_num_channels();
+
+  if ( chan < channels || chan - channels >= _subchannels.size() )
+    return NULL;
+
+  return &_subchannels[ chan - channels ];
+}
+
 bool source_impl::seek( long seek_point, int whence, size_t chan )
 {
   size_t channel = 0;
@@ -453,12 +648,38 @@ bool source_impl::seek( long seek_point, int whence, size_t chan )
   return false;
 }
 
+bool source_impl::seek_time( const osmosdr::time_spec_t &time, size_t chan )
+{
+  size_t channel = 0;
+  for (source_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ )
+        return dev->seek_time( time, dev_chan );
+
+  return false;
+}
+
+bool source_impl::seek_segment( size_t segment, size_t chan )
+{
+  size_t channel = 0;
+  for (source_iface *dev : _devs)
+    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+      if ( chan == channel++ )
+        return dev->seek_segment( segment, dev_chan );
+
+  return false;
+}
+
 #define NO_DEVICES_MSG  "FATAL: No device(s) available to work with."
 
 osmosdr::meta_range_t source_impl::get_sample_rates()
 {
-  if ( ! _devs.empty() )
+  if ( ! _devs.empty() ) {
+    if ( _resamplers[0] )
+      return resampler_c::output_rates( _devs[0]->get_sample_rates() );
+
     return _devs[0]->get_sample_rates(); // assume same devices used in the group
+  }
 #if 0
   else
     throw std::runtime_error(NO_DEVICES_MSG);
@@ -475,14 +696,37 @@ double source_impl::set_sample_rate(double rate)
     if (_devs.empty())
       throw std::runtime_error(NO_DEVICES_MSG);
 #endif
-    for (source_iface *dev : _devs)
-      sample_rate = dev->set_sample_rate(rate);
+    for (size_t i = 0; i < _devs.size(); i++) {
+      if ( _resamplers[i] ) {
+        double hw_rate = resampler_c::hardware_rate( _devs[i]->get_sample_rates(), rate );
+        double dev_rate = _devs[i]->set_sample_rate(hw_rate);
+        if ( _frontends[i] )
+          _frontends[i]->set_sample_rate(dev_rate);
+        sample_rate = _resamplers[i]->set_rates(dev_rate, rate);
+      } else {
+        sample_rate = _devs[i]->set_sample_rate(rate);
+        if ( _frontends[i] )
+          _frontends[i]->set_sample_rate(sample_rate);
+      }
+
+      if ( _channelizers[i] )
+        _channelizers[i]->set_sample_rate( _devs[i]->get_sample_rate() );
+
+      for (squelch_c *squelch : _squelches[i])
+        squelch->set_sample_rate( sample_rate );
+
+      if ( _spectra[i] )
+        _spectra[i]->set_sample_rate( sample_rate );
+
+      if ( _sweeps[i] )
+        _sweeps[i]->set_sample_rate( sample_rate );
+    }
 
 #ifdef HAVE_IQBALANCE
     size_t channel = 0;
     for (source_iface *dev : _devs) {
       for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
-        if ( channel < _iq_opt.size() ) {
+        if ( channel < _iq_opt.size() && _iq_opt[channel] ) {
           gr::iqbalance::optimize_c *opt = _iq_opt[channel];
 
           if ( opt->period() > 0 ) { /* optimize is enabled */
@@ -506,7 +750,9 @@ double source_impl::get_sample_rate()
 {
   double sample_rate = 0;
 
-  if (!_devs.empty())
+  if (!_devs.empty() && _resamplers[0])
+    sample_rate = _resamplers[0]->get_sample_rate(); // the exact delivered rate
+  else if (!_devs.empty())
     sample_rate = _devs[0]->get_sample_rate(); // assume same devices used in the group
 #if 0
   else
@@ -528,13 +774,34 @@ osmosdr::freq_range_t source_impl::get_freq_range( size_t chan )
 
 double source_impl::set_center_freq( double freq, size_t chan )
 {
+  if ( const std::pair< channelizer_c *, size_t > *sub = get_subchannel( chan ) ) {
+    double center = sub->first->get_center_freq();
+    return center + sub->first->set_offset( freq - center, sub->second );
+  }
+
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ ) {
-        if ( _center_freq[ chan ] != freq ) {
-          _center_freq[ chan ] = freq;
-          return dev->set_center_freq( freq, dev_chan );
+        /* a sweep retunes behind our back, the cached value goes stale */
+        bool swept = _sweeps[i] && 0 == dev_chan;
+        if ( swept )
+          _center_freq.erase( chan );
+
+        if ( swept || _center_freq[ chan ] != freq ) {
+          if ( !swept )
+            _center_freq[ chan ] = freq;
+          software_frontend_c *frontend = _frontends[i];
+          double lo_offset = frontend ? frontend->get_lo_offset() : 0;
+          if ( frontend && frontend->has_command_time() ) /* emulated timed retune */
+            freq = frontend->schedule_center_freq( freq + lo_offset, dev_chan );
+          else {
+            freq = _devs[i]->set_center_freq( freq + lo_offset, dev_chan );
+            if ( frontend )
+              frontend->tag_center_freq( freq, dev_chan );
+          }
+          /* sub-channels follow the rx_freq tags, keeping their offsets */
+          return freq - lo_offset;
         } else { return _center_freq[ chan ]; }
       }
 
@@ -543,11 +810,15 @@ double source_impl::set_center_freq( double freq, size_t chan )
 
 double source_impl::get_center_freq( size_t chan )
 {
+  if ( const std::pair< channelizer_c *, size_t > *sub = get_subchannel( chan ) )
+    return sub->first->get_center_freq() + sub->first->get_offset( sub->second );
+
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ )
-        return dev->get_center_freq( dev_chan );
+        return _devs[i]->get_center_freq( dev_chan ) -
+               (_frontends[i] ? _frontends[i]->get_lo_offset() : 0);
 
   return 0;
 }
@@ -614,9 +885,13 @@ osmosdr::gain_range_t source_impl::get_gain_range( const std::string & name, siz
 bool source_impl::set_gain_mode( bool automatic, size_t chan )
 {
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ ) {
+        if ( _agc[i] ) /* software AGC, the hardware gain stays manual */
+          return _frontends[i]->set_agc_mode( automatic, dev_chan );
+
+        source_iface *dev = _devs[i];
         if ( (_gain_mode.count(chan) == 0) || (_gain_mode[ chan ] != automatic) ) {
           _gain_mode[ chan ] = automatic;
           bool mode = dev->set_gain_mode( automatic, dev_chan );
@@ -632,10 +907,14 @@ bool source_impl::set_gain_mode( bool automatic, size_t chan )
 bool source_impl::get_gain_mode( size_t chan )
 {
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->get_gain_mode( dev_chan );
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        if ( _agc[i] )
+          return _frontends[i]->get_agc_mode( dev_chan );
+
+        return _devs[i]->get_gain_mode( dev_chan );
+      }
 
   return false;
 }
@@ -758,29 +1037,39 @@ std::string source_impl::get_antenna( size_t chan )
 void source_impl::set_dc_offset_mode( int mode, size_t chan )
 {
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset_mode( mode, dev_chan );
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        if ( _devs[i]->has_dc_offset_correction( dev_chan ) )
+          _devs[i]->set_dc_offset_mode( mode, dev_chan );
+        else
+          _frontends[i]->set_dc_offset_mode( mode, dev_chan );
+      }
 }
 
 void source_impl::set_dc_offset( const std::complex<double> &offset, size_t chan )
 {
   size_t channel = 0;
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        dev->set_dc_offset( offset, dev_chan );
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
+      if ( chan == channel++ ) {
+        if ( _devs[i]->has_dc_offset_correction( dev_chan ) )
+          _devs[i]->set_dc_offset( offset, dev_chan );
+        else
+          _frontends[i]->set_dc_offset( offset, dev_chan );
+      }
 }
 
 void source_impl::set_iq_balance_mode( int mode, size_t chan )
 {
   size_t channel = 0;
-#ifdef HAVE_IQBALANCE
-  for (source_iface *dev : _devs) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
+        if ( _devs[i]->has_iq_balance_correction( dev_chan ) ) {
+          _devs[i]->set_iq_balance_mode( mode, dev_chan );
+#ifdef HAVE_IQBALANCE
+        } else if ( chan < _iq_opt.size() && _iq_opt[chan] ) {
           gr::iqbalance::optimize_c *opt = _iq_opt[chan];
           gr::iqbalance::fix_cc *fix = _iq_fix[chan];
 
@@ -799,29 +1088,26 @@ void source_impl::set_iq_balance_mode( int mode, size_t chan )
             }
             opt->set_period( 0 );
           } else if ( IQBalanceAutomatic == mode ) {
-            opt->set_period( dev->get_sample_rate() / 5 );
+            opt->set_period( _devs[i]->get_sample_rate() / 5 );
             opt->reset();
           }
+#endif
+        } else {
+          _frontends[i]->set_iq_balance_mode( mode, dev_chan );
         }
       }
-    }
-  }
-#else
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance_mode( mode, dev_chan );
-#endif
 }
 
 void source_impl::set_iq_balance( const std::complex<double> &balance, size_t chan )
 {
   size_t channel = 0;
-#ifdef HAVE_IQBALANCE
-  for (source_iface *dev : _devs) {
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++) {
+  for (size_t i = 0; i < _devs.size(); i++)
+    for (size_t dev_chan = 0; dev_chan < _devs[i]->get_num_channels(); dev_chan++)
       if ( chan == channel++ ) {
-        if ( chan < _iq_opt.size() && chan < _iq_fix.size() ) {
+        if ( _devs[i]->has_iq_balance_correction( dev_chan ) ) {
+          _devs[i]->set_iq_balance( balance, dev_chan );
+#ifdef HAVE_IQBALANCE
+        } else if ( chan < _iq_opt.size() && _iq_opt[chan] ) {
           gr::iqbalance::optimize_c *opt = _iq_opt[chan];
           gr::iqbalance::fix_cc *fix = _iq_fix[chan];
 
@@ -829,20 +1115,18 @@ void source_impl::set_iq_balance( const std::complex<double> &balance, size_t ch
             fix->set_mag( balance.real() );
             fix->set_phase( balance.imag() );
           }
+#endif
+        } else {
+          _frontends[i]->set_iq_balance( balance, dev_chan );
         }
       }
-    }
-  }
-#else
-  for (source_iface *dev : _devs)
-    for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
-      if ( chan == channel++ )
-        return dev->set_iq_balance( balance, dev_chan );
-#endif
 }
 
 double source_impl::set_bandwidth( double bandwidth, size_t chan )
 {
+  if ( const std::pair< channelizer_c *, size_t > *sub = get_subchannel( chan ) )
+    return sub->first->set_bandwidth( bandwidth, sub->second );
+
   size_t channel = 0;
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
@@ -858,6 +1142,9 @@ double source_impl::set_bandwidth( double bandwidth, size_t chan )
 
 double source_impl::get_bandwidth( size_t chan )
 {
+  if ( const std::pair< channelizer_c *, size_t > *sub = get_subchannel( chan ) )
+    return sub->first->get_bandwidth( sub->second );
+
   size_t channel = 0;
   for (source_iface *dev : _devs)
     for (size_t dev_chan = 0; dev_chan < dev->get_num_channels(); dev_chan++)
@@ -976,3 +1263,36 @@ void source_impl::set_time_unknown_pps(const osmosdr::time_spec_t &time_spec)
     dev->set_time_unknown_pps( time_spec );
   }
 }
+
+void source_impl::set_command_time(const osmosdr::time_spec_t &time_spec, size_t mboard)
+{
+  /* devices without timed commands always have a frontend emulating them */
+  if (mboard != osmosdr::ALL_MBOARDS){
+      bool timed = _devs.at(mboard)->set_command_time( time_spec );
+      if ( _frontends.at(mboard) )
+        _frontends.at(mboard)->set_command_time( time_spec, !timed );
+      return;
+  }
+
+  for (size_t m = 0; m < _devs.size(); m++){ /* propagate ALL_MBOARDS */
+      bool timed = _devs.at(m)->set_command_time( time_spec, osmosdr::ALL_MBOARDS );
+      if ( _frontends.at(m) )
+        _frontends.at(m)->set_command_time( time_spec, !timed );
+  }
+}
+
+void source_impl::clear_command_time(size_t mboard)
+{
+  if (mboard != osmosdr::ALL_MBOARDS){
+      _devs.at(mboard)->clear_command_time();
+      if ( _frontends.at(mboard) )
+        _frontends.at(mboard)->clear_command_time();
+      return;
+  }
+
+  for (size_t m = 0; m < _devs.size(); m++){ /* propagate ALL_MBOARDS */
+      _devs.at(m)->clear_command_time( osmosdr::ALL_MBOARDS );
+      if ( _frontends.at(m) )
+        _frontends.at(m)->clear_command_time();
+  }
+}
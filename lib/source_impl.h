@@ -31,6 +31,13 @@
 
 #include <map>
 
+class software_frontend_c;
+class resampler_c;
+class channelizer_c;
+class squelch_c;
+class spectrum_c;
+class sweep_c;
+
 class source_impl : public osmosdr::source
 {
 public:
@@ -39,6 +46,8 @@ public:
   size_t get_num_channels( void );
 
   bool seek( long seek_point, int whence, size_t chan );
+  bool seek_time( const osmosdr::time_spec_t &time, size_t chan );
+  bool seek_segment( size_t segment, size_t chan );
 
   osmosdr::meta_range_t get_sample_rates( void );
   double set_sample_rate( double rate );
@@ -91,8 +100,22 @@ public:
   void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
+  void set_command_time(const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0);
+  void clear_command_time(size_t mboard = 0);
+
 private:
+  const std::pair< channelizer_c *, size_t > *get_subchannel( size_t chan );
+
   std::vector< source_iface * > _devs;
+  std::vector< software_frontend_c * > _frontends;
+  std::vector< resampler_c * > _resamplers; /* NULL unless resample=1 */
+  std::vector< channelizer_c * > _channelizers; /* NULL unless channelize=... */
+  std::vector< std::vector< squelch_c * > > _squelches; /* per device channel */
+  std::vector< spectrum_c * > _spectra; /* NULL unless spectrum=... */
+  std::vector< sweep_c * > _sweeps; /* NULL unless sweep=... */
+  std::vector< bool > _agc; /* set_gain_mode() switches the software AGC */
+  /* outputs following the device channels: channelizer and its output */
+  std::vector< std::pair< channelizer_c *, size_t > > _subchannels;
 
   /* cache to prevent multiple device calls with the same value coming from grc */
   double _sample_rate;
@@ -104,6 +127,7 @@ private:
   std::map< size_t, double > _bb_gain;
   std::map< size_t, std::string > _antenna;
 #ifdef HAVE_IQBALANCE
+  /* per channel, NULL unless iqbal=gr and the device can't correct the balance */
   std::vector< gr::iqbalance::fix_cc * > _iq_fix;
   std::vector< gr::iqbalance::optimize_c * > _iq_opt;
   std::map< size_t, std::pair<float, float> > _vals;
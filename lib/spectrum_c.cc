@@ -0,0 +1,273 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/window.h>
+#include <volk/volk.h>
+
+#include "spectrum_c.h"
+
+#define SPECTRUM_FRAMES 4 /* frames averaged per output vector */
+#define SPECTRUM_QUEUE 8 /* frames waiting for the worker before dropping */
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+
+spectrum_c_sptr make_spectrum_c( size_t fft_size, double rate,
+                                 double update_rate, double alpha )
+{
+  return gnuradio::get_initial_sptr( new spectrum_c( fft_size, rate, update_rate, alpha ) );
+}
+
+spectrum_c::spectrum_c( size_t fft_size, double rate, double update_rate, double alpha )
+  : gr::block( "spectrum_c",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( 1, 1, fft_size * sizeof(float) ) ),
+    _fft_size( fft_size ),
+    _update_rate( update_rate ),
+    _alpha( alpha ),
+    _interval( fft_size ),
+    _skip( 0 ),
+    _frame( fft_size ),
+    _filled( 0 ),
+    _tag_freq( false ),
+    _running( false ),
+    _generation( 0 ),
+    _result( fft_size ),
+    _fresh( false ),
+    _power( fft_size ),
+    _average( fft_size ),
+    _db( fft_size )
+{
+  if ( fft_size < 2 )
+    throw std::runtime_error( "The spectrum needs at least 2 bins." );
+
+  if ( update_rate <= 0 || alpha <= 0 || alpha > 1 )
+    throw std::runtime_error( "Invalid spectrum update rate or averaging weight." );
+
+  _id = pmt::string_to_symbol( alias() );
+  set_tag_propagation_policy( TPP_DONT );
+
+  _window = gr::fft::window::build( gr::fft::window::WIN_BLACKMAN_hARRIS, fft_size );
+
+  /* a full scale tone reads 0 dB in its bin */
+  double sum = 0;
+  for (float w : _window)
+    sum += w;
+  _scale = 1.0 / ( sum * sum );
+
+  _fft.reset( new gr::fft::fft_complex_fwd( fft_size ) );
+
+  set_sample_rate( rate );
+}
+
+spectrum_c::~spectrum_c()
+{
+  stop();
+}
+
+void spectrum_c::set_sample_rate( double rate )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  _interval = std::max< uint64_t >( _fft_size, rate / ( _update_rate * SPECTRUM_FRAMES ) );
+  _skip = std::min( _skip, _interval - _fft_size );
+
+  set_relative_rate( 1, _interval * SPECTRUM_FRAMES );
+}
+
+bool spectrum_c::start()
+{
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+    _running = true;
+  }
+
+  _thread = gr::thread::thread( _spectrum_worker, this );
+
+  return gr::block::start();
+}
+
+bool spectrum_c::stop()
+{
+  {
+    std::lock_guard< std::mutex > lock( _mutex );
+    _running = false;
+  }
+
+  _cond.notify_one();
+
+  if ( _thread.joinable() )
+    _thread.join();
+
+  return gr::block::stop();
+}
+
+void spectrum_c::_spectrum_worker( spectrum_c *obj )
+{
+  obj->spectrum_worker();
+}
+
+void spectrum_c::spectrum_worker()
+{
+  unsigned int generation = 0;
+  unsigned int averaged = 0;
+  size_t shift = ( _fft_size + 1 ) / 2; /* brings DC to the middle */
+
+  std::unique_lock< std::mutex > lock( _mutex );
+
+  while ( true ) {
+    _cond.wait( lock, [this] { return !_running || !_frames.empty(); } );
+
+    if ( !_running )
+      break;
+
+    std::pair< unsigned int, std::vector< gr_complex > > frame = std::move( _frames.front() );
+    _frames.pop_front();
+
+    lock.unlock();
+
+    /* the tuning changed, start over */
+    if ( frame.first != generation ) {
+      generation = frame.first;
+      averaged = 0;
+    }
+
+    volk_32fc_32f_multiply_32fc( _fft->get_inbuf(), frame.second.data(),
+                                 _window.data(), _fft_size );
+    _fft->execute();
+    volk_32fc_magnitude_squared_32f( _power.data(), _fft->get_outbuf(), _fft_size );
+
+    if ( 0 == averaged ) {
+      _average = _power;
+    } else {
+      for (size_t i = 0; i < _fft_size; i++)
+        _average[i] += _alpha * ( _power[i] - _average[i] );
+    }
+
+    if ( ++averaged % SPECTRUM_FRAMES == 0 ) {
+      for (size_t i = 0; i < _fft_size; i++)
+        _db[i] = 10.0f * std::log10( _average[ ( i + shift ) % _fft_size ] * _scale + 1e-20f );
+    }
+
+    lock.lock();
+
+    if ( averaged % SPECTRUM_FRAMES == 0 && generation == _generation ) {
+      _result.swap( _db );
+      _fresh = true;
+    }
+  }
+}
+
+/* must be called with _mutex held */
+void spectrum_c::capture( const gr_complex *in, int nitems )
+{
+  while ( nitems > 0 ) {
+    if ( _skip ) {
+      int skip = std::min< uint64_t >( _skip, nitems );
+      _skip -= skip;
+      in += skip;
+      nitems -= skip;
+      continue;
+    }
+
+    int count = std::min< size_t >( _fft_size - _filled, nitems );
+    memcpy( &_frame[_filled], in, count * sizeof(gr_complex) );
+    _filled += count;
+    in += count;
+    nitems -= count;
+
+    if ( _filled == _fft_size ) {
+      if ( _frames.size() < SPECTRUM_QUEUE ) {
+        _frames.push_back( std::make_pair( _generation, _frame ) );
+        _cond.notify_one();
+      }
+
+      _filled = 0;
+      _skip = _interval - _fft_size;
+    }
+  }
+}
+
+void spectrum_c::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  /* outputs come from the worker, any amount of input will do */
+  ninput_items_required[0] = 1;
+}
+
+int spectrum_c::general_work( int noutput_items,
+                              gr_vector_int &ninput_items,
+                              gr_vector_const_void_star &input_items,
+                              gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  float *out = (float *) output_items[0];
+  int nitems = ninput_items[0];
+
+  std::vector< gr::tag_t > tags;
+  get_tags_in_window( tags, 0, 0, nitems, FREQ_KEY );
+  std::sort( tags.begin(), tags.end(), gr::tag_t::offset_compare );
+
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  int pos = 0;
+
+  for (const gr::tag_t &tag : tags) {
+    int offset = tag.offset - nitems_read(0);
+
+    capture( in + pos, offset - pos );
+    pos = offset;
+
+    /* frames and results from before the retune are stale */
+    _generation++;
+    _frames.clear();
+    _fresh = false;
+    _filled = 0;
+    _skip = 0;
+
+    _freq = tag.value;
+    _tag_freq = true;
+  }
+
+  capture( in + pos, nitems - pos );
+
+  int produced = 0;
+
+  if ( _fresh ) {
+    memcpy( out, _result.data(), _fft_size * sizeof(float) );
+    _fresh = false;
+
+    if ( _tag_freq ) {
+      add_item_tag( 0, nitems_written(0), FREQ_KEY, _freq, _id );
+      _tag_freq = false;
+    }
+
+    produced = 1;
+  }
+
+  consume_each( nitems );
+
+  return produced;
+}
@@ -0,0 +1,120 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_SPECTRUM_C_H
+#define INCLUDED_SPECTRUM_C_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/fft/fft.h>
+#include <gnuradio/thread/thread.h>
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+class spectrum_c;
+
+typedef std::shared_ptr< spectrum_c > spectrum_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of spectrum_c.
+ *
+ * \param fft_size number of bins of each output vector
+ * \param rate sample rate of the stream
+ * \param update_rate output vectors per second
+ * \param alpha weight of a new frame in the running average
+ */
+spectrum_c_sptr make_spectrum_c( size_t fft_size, double rate,
+                                 double update_rate, double alpha );
+
+/*!
+ * \brief Power spectrum of a stream at a low, fixed update rate.
+ *
+ * Only SPECTRUM_FRAMES frames of fft_size samples are copied out of the
+ * stream per output vector, the rest is consumed untouched.  Windowing,
+ * FFT and averaging run on a worker thread, so the streaming thread pays
+ * for the copy alone.
+ *
+ * Each output vector holds fft_size bins in dBFS with DC in the middle.
+ * The average restarts when an rx_freq tag marks a retune.
+ */
+class spectrum_c : public gr::block
+{
+private:
+  friend spectrum_c_sptr make_spectrum_c( size_t fft_size, double rate,
+                                          double update_rate, double alpha );
+
+  spectrum_c( size_t fft_size, double rate, double update_rate, double alpha );
+
+public:
+  ~spectrum_c();
+
+  void set_sample_rate( double rate );
+
+  bool start();
+  bool stop();
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  static void _spectrum_worker( spectrum_c *obj );
+  void spectrum_worker();
+  void capture( const gr_complex *in, int nitems );
+
+  pmt::pmt_t _id;
+  size_t _fft_size;
+  double _update_rate;
+  float _alpha;
+  std::vector< float > _window;
+  float _scale;
+
+  /* capture, owned by the streaming thread */
+  uint64_t _interval;
+  uint64_t _skip;
+  std::vector< gr_complex > _frame;
+  size_t _filled;
+  pmt::pmt_t _freq;
+  bool _tag_freq;
+
+  /* shared with the worker */
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  bool _running;
+  unsigned int _generation;
+  std::deque< std::pair< unsigned int, std::vector< gr_complex > > > _frames;
+  std::vector< float > _result;
+  bool _fresh;
+
+  /* owned by the worker */
+  gr::thread::thread _thread;
+  std::unique_ptr< gr::fft::fft_complex_fwd > _fft;
+  std::vector< float > _power;
+  std::vector< float > _average;
+  std::vector< float > _db;
+};
+
+#endif /* INCLUDED_SPECTRUM_C_H */
@@ -0,0 +1,246 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+#include <volk/volk.h>
+
+#include "squelch_c.h"
+
+#define SQUELCH_WINDOW 256
+#define SQUELCH_HYSTERESIS 3.0 /* dB */
+
+static const pmt::pmt_t TIME_KEY = pmt::string_to_symbol("rx_time");
+static const pmt::pmt_t SOB_KEY = pmt::string_to_symbol("rx_sob");
+static const pmt::pmt_t EOB_KEY = pmt::string_to_symbol("rx_eob");
+
+squelch_c_sptr make_squelch_c( source_iface *dev, double threshold,
+                               double guard, double rate )
+{
+  return gnuradio::get_initial_sptr( new squelch_c( dev, threshold, guard, rate ) );
+}
+
+squelch_c::squelch_c( source_iface *dev, double threshold, double guard, double rate )
+  : gr::block( "squelch_c",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ) ),
+    _dev( dev ),
+    _updated( false ),
+    _rate( 0 ),
+    _guard( std::max( guard, 0.0 ) ),
+    _delay( SQUELCH_WINDOW ),
+    _active( false ),
+    _hang_windows( 0 ),
+    _hang( 0 ),
+    _forward( false ),
+    _in_burst( false ),
+    _burst_start( 0 ),
+    _reanchor( true ),
+    _anchor_sample( 0 )
+{
+  _id = pmt::string_to_symbol( alias() );
+
+  _open = std::pow( 10.0, threshold / 10 );
+  _close = std::pow( 10.0, ( threshold - SQUELCH_HYSTERESIS ) / 10 );
+
+  /* dropped samples take their tags along */
+  set_tag_propagation_policy( TPP_DONT );
+
+  set_sample_rate( rate );
+  _updated = false;
+}
+
+void squelch_c::set_sample_rate( double rate )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  int guard = rate > 0 ? int( std::ceil( _guard * rate ) ) : 0;
+
+  _rate = rate;
+  _delay = guard + SQUELCH_WINDOW;
+  /* a burst may end anywhere in the last window it was detected in */
+  _hang_windows = ( 2 * guard + 2 * SQUELCH_WINDOW - 1 ) / SQUELCH_WINDOW;
+  set_history( _delay + 1 );
+
+  _updated = true;
+  _reanchor = true;
+}
+
+void squelch_c::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  int windows = ( noutput_items + SQUELCH_WINDOW - 1 ) / SQUELCH_WINDOW;
+
+  ninput_items_required[0] = windows * SQUELCH_WINDOW + _delay;
+}
+
+/* must be called with _mutex held */
+pmt::pmt_t squelch_c::burst_info( uint64_t sample )
+{
+  double delta = _rate > 0 ? ( double(sample) - double(_anchor_sample) ) / _rate : 0;
+  ::osmosdr::time_spec_t time = _anchor_time + ::osmosdr::time_spec_t( delta );
+
+  pmt::pmt_t info = pmt::make_dict();
+  info = pmt::dict_add( info, pmt::mp("time"),
+                        pmt::make_tuple( pmt::from_uint64( uint64_t( time.get_full_secs() ) ),
+                                         pmt::from_double( time.get_frac_secs() ) ) );
+  info = pmt::dict_add( info, pmt::mp("sample"), pmt::from_uint64( sample ) );
+
+  return info;
+}
+
+/*
+ * Hand on the queued tags of the delayed samples start to end, or hold
+ * them back for the next burst.  Must be called with _mutex held.
+ */
+void squelch_c::pass_tags( uint64_t start, uint64_t end, int64_t out_offset, bool forwarded )
+{
+  while ( ! _tags.empty() && _tags.front().offset < end ) {
+    gr::tag_t tag = _tags.front();
+    _tags.pop_front();
+
+    if ( pmt::eq( tag.key, TIME_KEY ) ) {
+      _anchor_sample = tag.offset;
+      _anchor_time = ::osmosdr::time_spec_t( time_t( pmt::to_uint64( pmt::tuple_ref( tag.value, 0 ) ) ),
+                                             pmt::to_double( pmt::tuple_ref( tag.value, 1 ) ) );
+      _reanchor = false;
+    }
+
+    if ( forwarded ) {
+      tag.offset = out_offset + ( std::max( tag.offset, start ) - start );
+      add_item_tag( 0, tag );
+    } else if ( ! pmt::eq( tag.key, TIME_KEY ) ) {
+      /* only the latest value matters, rx_time is regenerated */
+      _held[ pmt::symbol_to_string( tag.key ) ] = tag;
+    }
+  }
+}
+
+int squelch_c::general_work( int noutput_items,
+                             gr_vector_int &ninput_items,
+                             gr_vector_const_void_star &input_items,
+                             gr_vector_void_star &output_items )
+{
+  std::lock_guard<std::mutex> lock( _mutex );
+
+  if ( _updated ) {
+    /* let the scheduler apply the new history first */
+    _updated = false;
+    return 0;
+  }
+
+  const gr_complex *in = (const gr_complex *)input_items[0];
+  gr_complex *out = (gr_complex *)output_items[0];
+  const uint64_t read = nitems_read(0);
+  const uint64_t written = nitems_written(0);
+
+  int windows = std::min( noutput_items, ninput_items[0] - _delay ) / SQUELCH_WINDOW;
+
+  if ( windows <= 0 )
+    return 0;
+
+  const int nin = windows * SQUELCH_WINDOW;
+
+  if ( _reanchor ) {
+    /* the newest samples are about the current device time */
+    _anchor_time = _dev->get_time_now();
+    _anchor_sample = read + nin;
+    _reanchor = false;
+  }
+
+  /* tags are queued as the detector sees them and passed on with the
+   * delayed samples */
+  std::vector< gr::tag_t > tags;
+  get_tags_in_range( tags, 0, read, read + nin );
+  _tags.insert( _tags.end(), tags.begin(), tags.end() );
+
+  int nout = 0;
+
+  for (int w = 0; w < windows; w++) {
+    const int pos = w * SQUELCH_WINDOW;
+    const gr_complex *look = in + _delay + pos;
+    gr_complex energy;
+
+    volk_32fc_x2_conjugate_dot_prod_32fc( &energy, look, look, SQUELCH_WINDOW );
+
+    float power = energy.real() / SQUELCH_WINDOW;
+
+    if ( ! _active && power > _open )
+      _active = true;
+    else if ( _active && power < _close )
+      _active = false;
+
+    if ( _active )
+      _hang = _hang_windows;
+    else if ( _hang )
+      _hang--;
+
+    /* the detector runs guard + one window ahead of the gate */
+    bool next = _active || _hang > 0;
+
+    int64_t sample = int64_t( read ) + pos - _delay;
+    bool forward = _forward && sample >= 0;
+
+    if ( forward ) {
+      uint64_t offset = written + nout;
+
+      if ( ! _in_burst ) {
+        _burst_start = sample;
+
+        for (std::pair< const std::string, gr::tag_t > &held : _held) {
+          held.second.offset = offset;
+          add_item_tag( 0, held.second );
+        }
+        _held.clear();
+
+        pmt::pmt_t info = burst_info( sample );
+        add_item_tag( 0, offset, TIME_KEY, pmt::dict_ref( info, pmt::mp("time"), pmt::PMT_NIL ), _id );
+        add_item_tag( 0, offset, SOB_KEY, info, _id );
+      }
+
+      memcpy( out + nout, in + pos, SQUELCH_WINDOW * sizeof(gr_complex) );
+      pass_tags( sample, sample + SQUELCH_WINDOW, offset, true );
+      nout += SQUELCH_WINDOW;
+
+      if ( ! next ) {
+        uint64_t last = sample + SQUELCH_WINDOW - 1;
+        pmt::pmt_t info = burst_info( last );
+        info = pmt::dict_add( info, pmt::mp("length"),
+                              pmt::from_uint64( last + 1 - _burst_start ) );
+        add_item_tag( 0, written + nout - 1, EOB_KEY, info, _id );
+      }
+    } else if ( sample + SQUELCH_WINDOW > 0 ) {
+      pass_tags( std::max< int64_t >( sample, 0 ), sample + SQUELCH_WINDOW, 0, false );
+    }
+
+    _in_burst = forward && next;
+    _forward = next;
+  }
+
+  consume_each( nin );
+
+  return nout;
+}
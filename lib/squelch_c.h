@@ -0,0 +1,115 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_SQUELCH_C_H
+#define INCLUDED_SQUELCH_C_H
+
+#include <gnuradio/block.h>
+
+#include <deque>
+#include <map>
+#include <mutex>
+
+#include "source_iface.h"
+
+class squelch_c;
+
+typedef std::shared_ptr< squelch_c > squelch_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of squelch_c.
+ *
+ * \param dev the device the stream comes from, used for timestamps
+ * \param threshold power in dBFS above which a burst starts
+ * \param guard time in seconds forwarded before and after each burst
+ * \param rate sample rate of the stream
+ */
+squelch_c_sptr make_squelch_c( source_iface *dev, double threshold,
+                               double guard, double rate );
+
+/*!
+ * \brief Forwards bursts of one channel and drops the silence between.
+ *
+ * The mean power of windows of SQUELCH_WINDOW samples is compared with
+ * the threshold; a burst ends when it falls 3 dB below.  The stream is
+ * delayed by the guard interval plus one window, so the gate opens guard
+ * seconds before a burst and closes guard seconds after it.
+ *
+ * The first sample of each burst carries an rx_time tag and an rx_sob
+ * tag, the last one an rx_eob tag.  Both hold a dict with the "time" as
+ * an rx_time tuple and the "sample" index in the ungated stream, the
+ * rx_eob tag also the "length" of the burst in samples.  Tags on dropped
+ * samples are held back and delivered with the next burst.
+ */
+class squelch_c : public gr::block
+{
+private:
+  friend squelch_c_sptr make_squelch_c( source_iface *dev, double threshold,
+                                        double guard, double rate );
+
+  squelch_c( source_iface *dev, double threshold, double guard, double rate );
+
+public:
+  void set_sample_rate( double rate );
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  pmt::pmt_t burst_info( uint64_t sample );
+  void pass_tags( uint64_t start, uint64_t end, int64_t out_offset, bool forwarded );
+
+  source_iface *_dev;
+  pmt::pmt_t _id;
+
+  std::mutex _mutex;
+  bool _updated;
+  double _rate;
+  double _guard;
+  int _delay;
+
+  /* detector */
+  float _open;
+  float _close;
+  bool _active;
+  unsigned int _hang_windows;
+  unsigned int _hang;
+
+  /* gate of the window about to be written and of the one before */
+  bool _forward;
+  bool _in_burst;
+  uint64_t _burst_start;
+
+  /* input tags not yet passed by the delayed stream */
+  std::deque< gr::tag_t > _tags;
+  std::map< std::string, gr::tag_t > _held;
+
+  /* relation between stream samples and device time */
+  bool _reanchor;
+  uint64_t _anchor_sample;
+  ::osmosdr::time_spec_t _anchor_time;
+};
+
+#endif /* INCLUDED_SQUELCH_C_H */
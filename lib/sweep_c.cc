@@ -0,0 +1,281 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <gnuradio/io_signature.h>
+#include <gnuradio/fft/window.h>
+#include <volk/volk.h>
+
+#include "software_frontend_c.h"
+#include "sweep_c.h"
+
+static const pmt::pmt_t FREQ_KEY = pmt::string_to_symbol("rx_freq");
+
+sweep_c_sptr make_sweep_c( software_frontend_c *frontend,
+                           const std::vector< double > &freqs, size_t bins,
+                           size_t dwell, size_t settle, double rate )
+{
+  return gnuradio::get_initial_sptr( new sweep_c( frontend, freqs, bins,
+                                                  dwell, settle, rate ) );
+}
+
+sweep_c::sweep_c( software_frontend_c *frontend, const std::vector< double > &freqs,
+                  size_t bins, size_t dwell, size_t settle, double rate )
+  : gr::block( "sweep_c",
+               gr::io_signature::make( 1, 1, sizeof(gr_complex) ),
+               gr::io_signature::make( 1, 1, freqs.size() * bins * sizeof(float) ) ),
+    _frontend( frontend ),
+    _freqs( freqs ),
+    _step( 0 ),
+    _bins( bins ),
+    _dwell( dwell ),
+    _settle( settle ),
+    _updated( true ),
+    _rate( rate ),
+    _fft_size( 0 ),
+    _frames_per_hop( 1 ),
+    _scale( 1 ),
+    _map( bins ),
+    _state( SWEEP_WAIT ),
+    _hop( 0 ),
+    _skip( 0 ),
+    _frames( 0 ),
+    _filled( 0 ),
+    _sweep( freqs.size() * bins ),
+    _result( freqs.size() * bins ),
+    _complete( false )
+{
+  if ( freqs.empty() || bins < 1 )
+    throw std::runtime_error( "The sweep needs at least one hop and one bin." );
+
+  /* a single hop spans the whole stream */
+  _step = freqs.size() > 1 ? freqs[1] - freqs[0] : rate;
+
+  _id = pmt::string_to_symbol( alias() );
+  set_tag_propagation_policy( TPP_DONT );
+}
+
+void sweep_c::set_sample_rate( double rate )
+{
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  if ( rate != _rate ) {
+    _rate = rate;
+    _updated = true;
+  }
+}
+
+/* must be called with _mutex held */
+void sweep_c::update_fft( void )
+{
+  if ( _rate <= 0 )
+    return;
+
+  /* bins of step / bins or finer, at least one output bin each */
+  _fft_size = std::max< size_t >( _bins, std::ceil( _bins * _rate / _step ) );
+  _frames_per_hop = std::max< size_t >( 1, _dwell / _fft_size );
+
+  _window = gr::fft::window::build( gr::fft::window::WIN_BLACKMAN_hARRIS, _fft_size );
+
+  /* a full scale tone reads 0 dB in its bin */
+  double sum = 0;
+  for (float w : _window)
+    sum += w;
+  _scale = 1.0 / ( sum * sum );
+
+  _fft.reset( new gr::fft::fft_complex_fwd( _fft_size ) );
+  _frame.resize( _fft_size );
+  _mag.resize( _fft_size );
+  _power.resize( _fft_size );
+
+  /* the FFT bin nearest to each output bin, DC of a hop is bin bins / 2 */
+  for (size_t j = 0; j < _bins; j++) {
+    double offset = ( double(j) - double(_bins / 2) ) * _step / _bins;
+    long index = std::lround( offset * _fft_size / _rate );
+    _map[j] = ( index + _fft_size ) % _fft_size;
+  }
+
+  set_relative_rate( 1, _freqs.size() * ( _settle + _frames_per_hop * _fft_size ) );
+}
+
+/* must be called with _mutex held */
+void sweep_c::retune( size_t hop )
+{
+  _hop = hop;
+  _state = SWEEP_WAIT;
+  _frontend->request_center_freq( _freqs[hop] + _frontend->get_lo_offset(), 0 );
+}
+
+/* must be called with _mutex held */
+void sweep_c::start_hop( double freq )
+{
+  if ( ! _frontend ) {
+    /* the device hops by itself, find out where it went */
+    double index = std::round( ( freq - _freqs[0] ) / _step );
+
+    if ( index < 0 || index >= _freqs.size() ||
+         std::abs( freq - _freqs[ size_t(index) ] ) >= _step / 2 ) {
+      _state = SWEEP_WAIT;
+      return;
+    }
+
+    _hop = size_t(index);
+  } else if ( _state != SWEEP_WAIT ) {
+    return; /* not ours */
+  }
+
+  _state = SWEEP_SETTLE;
+  _skip = _settle;
+  _frames = 0;
+  _filled = 0;
+  std::fill( _power.begin(), _power.end(), 0.0f );
+}
+
+/* must be called with _mutex held */
+void sweep_c::finish_hop( void )
+{
+  float scale = _scale / _frames;
+
+  for (size_t j = 0; j < _bins; j++)
+    _sweep[ _hop * _bins + j ] = _power[ _map[j] ] * scale;
+
+  bool last = ( _hop + 1 == _freqs.size() );
+
+  if ( last ) {
+    _result = _sweep;
+    _complete = true;
+  }
+
+  if ( _frontend )
+    retune( last ? 0 : _hop + 1 );
+  else
+    _state = SWEEP_WAIT;
+}
+
+/* must be called with _mutex held */
+void sweep_c::measure( const gr_complex *in, int nitems )
+{
+  while ( nitems > 0 && _state != SWEEP_WAIT ) {
+    if ( SWEEP_SETTLE == _state ) {
+      int skip = std::min< uint64_t >( _skip, nitems );
+      _skip -= skip;
+      in += skip;
+      nitems -= skip;
+
+      if ( 0 == _skip )
+        _state = SWEEP_DWELL;
+      continue;
+    }
+
+    int count = std::min< size_t >( _fft_size - _filled, nitems );
+    memcpy( &_frame[_filled], in, count * sizeof(gr_complex) );
+    _filled += count;
+    in += count;
+    nitems -= count;
+
+    if ( _filled < _fft_size )
+      break;
+
+    volk_32fc_32f_multiply_32fc( _fft->get_inbuf(), _frame.data(), _window.data(), _fft_size );
+    _fft->execute();
+    volk_32fc_magnitude_squared_32f( _mag.data(), _fft->get_outbuf(), _fft_size );
+    volk_32f_x2_add_32f( _power.data(), _power.data(), _mag.data(), _fft_size );
+
+    _filled = 0;
+
+    if ( ++_frames == _frames_per_hop )
+      finish_hop();
+  }
+}
+
+void sweep_c::forecast( int noutput_items, gr_vector_int &ninput_items_required )
+{
+  /* outputs depend on the hops, any amount of input will do */
+  ninput_items_required[0] = 1;
+}
+
+int sweep_c::general_work( int noutput_items,
+                           gr_vector_int &ninput_items,
+                           gr_vector_const_void_star &input_items,
+                           gr_vector_void_star &output_items )
+{
+  const gr_complex *in = (const gr_complex *) input_items[0];
+  float *out = (float *) output_items[0];
+  int nitems = ninput_items[0];
+
+  std::lock_guard< std::mutex > lock( _mutex );
+
+  if ( _updated ) {
+    update_fft();
+    _updated = false;
+
+    /* start over with the new FFT */
+    _state = SWEEP_WAIT;
+    _complete = false;
+    if ( _frontend && _fft_size )
+      retune( 0 );
+  }
+
+  if ( 0 == _fft_size ) {
+    consume_each( nitems );
+    return 0;
+  }
+
+  std::vector< gr::tag_t > tags;
+  get_tags_in_window( tags, 0, 0, nitems, FREQ_KEY );
+  std::sort( tags.begin(), tags.end(), gr::tag_t::offset_compare );
+
+  int pos = 0;
+
+  for (const gr::tag_t &tag : tags) {
+    int offset = tag.offset - nitems_read(0);
+
+    measure( in + pos, offset - pos );
+    pos = offset;
+
+    /* a hop of the device cuts the one before short */
+    if ( ! _frontend && SWEEP_DWELL == _state && _frames )
+      finish_hop();
+
+    if ( pmt::is_number( tag.value ) )
+      start_hop( pmt::to_double( tag.value ) );
+  }
+
+  measure( in + pos, nitems - pos );
+
+  int produced = 0;
+
+  if ( _complete ) {
+    for (size_t i = 0; i < _result.size(); i++)
+      out[i] = 10.0f * std::log10( _result[i] + 1e-20f );
+
+    _complete = false;
+    produced = 1;
+  }
+
+  consume_each( nitems );
+
+  return produced;
+}
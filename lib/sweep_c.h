@@ -0,0 +1,129 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2026 Free Software Foundation, Inc.
+ *
+ * This file is part of gr-osmosdr
+ *
+ * gr-osmosdr is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * gr-osmosdr is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with gr-osmosdr; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+#ifndef INCLUDED_SWEEP_C_H
+#define INCLUDED_SWEEP_C_H
+
+#include <gnuradio/block.h>
+#include <gnuradio/fft/fft.h>
+
+#include <memory>
+#include <mutex>
+
+class software_frontend_c;
+class sweep_c;
+
+typedef std::shared_ptr< sweep_c > sweep_c_sptr;
+
+/*!
+ * \brief Return a shared_ptr to a new instance of sweep_c.
+ *
+ * \param frontend retunes the device, NULL if the device hops by itself
+ * \param freqs the equally spaced center frequencies of the hops
+ * \param bins output bins per hop
+ * \param dwell samples measured on each hop, at least one FFT frame
+ * \param settle samples discarded after each retune
+ * \param rate sample rate of the stream
+ */
+sweep_c_sptr make_sweep_c( software_frontend_c *frontend,
+                           const std::vector< double > &freqs, size_t bins,
+                           size_t dwell, size_t settle, double rate );
+
+/*!
+ * \brief Stitches the power spectra of a frequency sweep into one vector.
+ *
+ * With a frontend, the block retunes the first channel of the device
+ * from its own thread as soon as a hop is measured.  The frontend marks
+ * the first sample read after the retune with an rx_freq tag, everything
+ * before it and the following settle samples are discarded.  Without a
+ * frontend the device hops by itself and each rx_freq tag starts the hop
+ * closest to its frequency.
+ *
+ * Each hop covers step / 2 on both sides of its frequency, bin j of hop
+ * k sits at freqs[k] + (j - bins / 2) * step / bins.  The frames of a hop
+ * are windowed, transformed and their power added up, then the bins are
+ * picked from the FFT.  When the last hop is done, a vector of all hops
+ * times bins values in dBFS is written, lowest frequency first.
+ */
+class sweep_c : public gr::block
+{
+private:
+  friend sweep_c_sptr make_sweep_c( software_frontend_c *frontend,
+                                    const std::vector< double > &freqs, size_t bins,
+                                    size_t dwell, size_t settle, double rate );
+
+  sweep_c( software_frontend_c *frontend, const std::vector< double > &freqs,
+           size_t bins, size_t dwell, size_t settle, double rate );
+
+public:
+  void set_sample_rate( double rate );
+
+  void forecast( int noutput_items, gr_vector_int &ninput_items_required );
+
+  int general_work( int noutput_items,
+                    gr_vector_int &ninput_items,
+                    gr_vector_const_void_star &input_items,
+                    gr_vector_void_star &output_items );
+
+private:
+  void update_fft( void );
+  void retune( size_t hop );
+  void start_hop( double freq );
+  void finish_hop( void );
+  void measure( const gr_complex *in, int nitems );
+
+  software_frontend_c *_frontend;
+  pmt::pmt_t _id;
+
+  std::vector< double > _freqs;
+  double _step;
+  size_t _bins;
+  size_t _dwell;
+  size_t _settle;
+
+  std::mutex _mutex;
+  bool _updated;
+  double _rate;
+
+  /* FFT of a hop and where its bins are taken from */
+  size_t _fft_size;
+  size_t _frames_per_hop;
+  std::unique_ptr< gr::fft::fft_complex_fwd > _fft;
+  std::vector< float > _window;
+  float _scale;
+  std::vector< size_t > _map;
+
+  enum { SWEEP_WAIT, SWEEP_SETTLE, SWEEP_DWELL } _state;
+  size_t _hop;
+  uint64_t _skip;
+  size_t _frames;
+  size_t _filled;
+  std::vector< gr_complex > _frame;
+  std::vector< float > _mag;
+  std::vector< float > _power;
+
+  /* linear power of the sweep in progress and of the last complete one */
+  std::vector< float > _sweep;
+  std::vector< float > _result;
+  bool _complete;
+};
+
+#endif /* INCLUDED_SWEEP_C_H */
@@ -71,9 +71,11 @@ public:
   std::string set_antenna( const std::string & antenna, size_t chan = 0 );
   std::string get_antenna( size_t chan = 0 );
 
+  bool has_dc_offset_correction( size_t chan = 0 ) { return true; }
   void set_dc_offset_mode( int mode, size_t chan = 0 );
   void set_dc_offset( const std::complex<double> &offset, size_t chan = 0 );
 
+  bool has_iq_balance_correction( size_t chan = 0 ) { return true; }
   void set_iq_balance_mode( int mode, size_t chan = 0 );
   void set_iq_balance( const std::complex<double> &balance, size_t chan = 0 );
 
@@ -95,6 +97,11 @@ public:
   void set_time_next_pps(const ::osmosdr::time_spec_t &time_spec);
   void set_time_unknown_pps(const ::osmosdr::time_spec_t &time_spec);
 
+  bool has_retune_tags( void ) { return true; } /* usrp_source tags each tune */
+  bool has_timed_commands( void ) { return true; }
+  bool set_command_time(const ::osmosdr::time_spec_t &time_spec, size_t mboard = 0);
+  void clear_command_time(size_t mboard = 0);
+
 private:
   double _center_freq;
   double _freq_corr;
@@ -18,8 +18,11 @@
  * Boston, MA 02110-1301, USA.
  */
 #include "xtrx_obj.h"
+#include <cmath>
 #include <iostream>
+#include <set>
 #include <sstream>
+#include <stdexcept>
 #include <boost/thread.hpp>
 #include <boost/thread/thread.hpp>
 #include <boost/thread/mutex.hpp>
@@ -79,11 +82,13 @@ xtrx_obj::xtrx_obj(const std::string &path, unsigned loglevel, bool lmsreset)
   }
 
   _devices = res;
+  _chan_mtx.reset(new boost::mutex[2 * 2 * _devices]);
+  _drv_mtx.reset(new boost::mutex[_devices]);
 }
 
 double xtrx_obj::set_smaplerate(double rate, double master, bool sink, unsigned flags)
 {
-  boost::mutex::scoped_lock lock(mtx);
+  boost::unique_lock<boost::shared_mutex> lock(_board_mtx);
 
   if (sink) {
     _sink_rate = rate;
@@ -128,11 +133,153 @@ double xtrx_obj::set_smaplerate(double rate, double master, bool sink, unsigned
   return rxrate;
 }
 
+xtrx_obj::chan_settings_t::chan_settings_t(xtrx_direction_t dir, size_t chan)
+  : dir(dir)
+  , chan(chan)
+  , tune((dir == XTRX_TX) ? XTRX_TUNE_TX_FDD : XTRX_TUNE_RX_FDD)
+  , freq(NAN)
+  , bb_freq(NAN)
+  , gain_type((dir == XTRX_TX) ? XTRX_TX_PAD_GAIN : XTRX_RX_LNA_GAIN)
+  , gain(NAN)
+  , bandwidth(NAN)
+  , actual_freq(NAN)
+  , actual_gain(NAN)
+  , actual_bandwidth(NAN)
+{
+}
+
+boost::mutex& xtrx_obj::chan_mtx(xtrx_direction_t dir, size_t chan)
+{
+  size_t nchan = 2 * _devices;
+  if (chan >= nchan)
+    throw std::out_of_range("xtrx_obj: channel index out of range");
+
+  return _chan_mtx[((dir == XTRX_TX) ? nchan : 0) + chan];
+}
+
+boost::mutex& xtrx_obj::drv_mtx(size_t chan)
+{
+  if (chan >= 2 * _devices)
+    throw std::out_of_range("xtrx_obj: channel index out of range");
+
+  /* two channels per chip */
+  return _drv_mtx[chan / 2];
+}
+
+namespace {
+  /* Entries sharing the same (kind, value) pair and the mask they form */
+  struct chan_group {
+    unsigned mask;
+    std::vector<xtrx_obj::chan_settings_t *> entries;
+  };
+  typedef std::map<std::pair<int, double>, chan_group> chan_groups;
+
+  template <typename Key>
+  chan_groups group_settings(xtrx_obj::chan_settings_list& batch, Key key)
+  {
+    chan_groups groups;
+    for (xtrx_obj::chan_settings_t& s : batch) {
+      std::pair<int, double> k = key(s);
+      if (std::isnan(k.second))
+        continue;
+
+      chan_group& g = groups[k];
+      g.mask |= XTRX_CH_A << s.chan;
+      g.entries.push_back(&s);
+    }
+    return groups;
+  }
+}
+
+int xtrx_obj::commit(chan_settings_list& batch, const std::function<void ()>& update)
+{
+  /* Take every channel lock the batch needs in address order, so two
+   * commits touching overlapping channels can't deadlock.  The chip
+   * locks follow in the same way. */
+  std::set<boost::mutex *> mtxs, drvs;
+  for (const chan_settings_t& s : batch) {
+    if (s.dir == XTRX_RX || s.tune == XTRX_TUNE_TX_AND_RX_TDD)
+      mtxs.insert(&chan_mtx(XTRX_RX, s.chan));
+    if (s.dir == XTRX_TX)
+      mtxs.insert(&chan_mtx(XTRX_TX, s.chan));
+    drvs.insert(&drv_mtx(s.chan));
+  }
+
+  boost::shared_lock<boost::shared_mutex> board(_board_mtx);
+  std::vector< boost::unique_lock<boost::mutex> > locks;
+  for (boost::mutex *m : mtxs)
+    locks.emplace_back(*m);
+
+  std::vector< boost::unique_lock<boost::mutex> > drv;
+  for (boost::mutex *m : drvs)
+    drv.emplace_back(*m);
+
+  int err = 0;
+
+  for (auto& g : group_settings(batch, [](chan_settings_t& s) {
+         return std::make_pair(int(s.tune), s.freq); })) {
+    double actual = g.first.second;
+    int res = xtrx_tune_ex(_obj, xtrx_tune_t(g.first.first),
+                           xtrx_channel_t(g.second.mask), g.first.second, &actual);
+    if (res) {
+      std::cerr << "Unable to deliver frequency " << g.first.second << std::endl;
+      err = res;
+    }
+    for (chan_settings_t *s : g.second.entries)
+      s->actual_freq = actual;
+  }
+
+  for (auto& g : group_settings(batch, [](chan_settings_t& s) {
+         return std::make_pair(int((s.dir == XTRX_TX) ? XTRX_TUNE_BB_TX : XTRX_TUNE_BB_RX),
+                               s.bb_freq); })) {
+    int res = xtrx_tune_ex(_obj, xtrx_tune_t(g.first.first),
+                           xtrx_channel_t(g.second.mask), g.first.second, NULL);
+    if (res) {
+      std::cerr << "Unable to set NCO to " << g.first.second << std::endl;
+      err = res;
+    }
+  }
+
+  for (auto& g : group_settings(batch, [](chan_settings_t& s) {
+         return std::make_pair(int(s.dir), s.bandwidth); })) {
+    double actual = g.first.second;
+    int res = (g.first.first == XTRX_TX)
+        ? xtrx_tune_tx_bandwidth(_obj, xtrx_channel_t(g.second.mask), g.first.second, &actual)
+        : xtrx_tune_rx_bandwidth(_obj, xtrx_channel_t(g.second.mask), g.first.second, &actual);
+    if (res) {
+      std::cerr << "Can't set bandwidth: " << res << std::endl;
+      err = res;
+    }
+    for (chan_settings_t *s : g.second.entries)
+      s->actual_bandwidth = actual;
+  }
+
+  for (auto& g : group_settings(batch, [](chan_settings_t& s) {
+         return std::make_pair(int(s.gain_type), s.gain); })) {
+    double actual = g.first.second;
+    int res = xtrx_set_gain(_obj, xtrx_channel_t(g.second.mask),
+                            xtrx_gain_type_t(g.first.first), g.first.second, &actual);
+    if (res) {
+      std::cerr << "Unable to set gain " << g.first.first << "; err=" << res << std::endl;
+      err = res;
+    }
+    for (chan_settings_t *s : g.second.entries)
+      s->actual_gain = actual;
+  }
+
+  drv.clear();
+
+  if (update)
+    update();
+
+  return err;
+}
+
 xtrx_obj::~xtrx_obj()
 {
   if (_obj) {
     if (_run) {
-      //boost::mutex::scoped_lock lock(mtx);
+      //boost::unique_lock<boost::shared_mutex> lock(_board_mtx);
       xtrx_stop(_obj, XTRX_TRX);
     }
     xtrx_close(_obj);
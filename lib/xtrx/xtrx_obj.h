@@ -22,9 +22,12 @@
 
 #include <boost/shared_ptr.hpp>
 #include <xtrx_api.h>
+#include <functional>
 #include <map>
+#include <memory>
 #include <vector>
 #include <boost/thread/mutex.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 class xtrx_obj;
 
@@ -50,7 +53,48 @@ public:
 
   void set_vio(unsigned vio) { _vio = vio; }
 
-  boost::mutex mtx;
+  /* One entry of a batched settings commit.  Fields left at NAN are not
+   * touched, the actual_* members are filled in by commit(). */
+  struct chan_settings_t
+  {
+    chan_settings_t(xtrx_direction_t dir, size_t chan);
+
+    xtrx_direction_t dir;       // XTRX_RX or XTRX_TX
+    size_t           chan;
+
+    xtrx_tune_t      tune;      // LO tuning mode, FDD by default
+    double           freq;
+    double           bb_freq;   // NCO offset applied after the LO
+    xtrx_gain_type_t gain_type;
+    double           gain;
+    double           bandwidth;
+
+    double           actual_freq;
+    double           actual_gain;
+    double           actual_bandwidth;
+  };
+  typedef std::vector<chan_settings_t> chan_settings_list;
+
+  /* Applies frequency, gain and bandwidth for several channels at once.
+   * Channels receiving the same value for a setting are merged into one
+   * channel mask, so tuning A and B of a MIMO pair is a single driver
+   * call.  update is called with the channel locks still held, for the
+   * blocks to cache the actual_* values.  Returns the last driver error
+   * or 0. */
+  int commit(chan_settings_list& batch,
+             const std::function<void ()>& update = std::function<void ()>());
+
+  /* Board wide operations (sample rate, run/stop) hold board_mtx()
+   * exclusively.  Per channel settings hold it shared together with the
+   * lock of the channel they touch, which also guards the settings the
+   * blocks cache for that channel.  RX and TX of one LMS7002M are reached
+   * through its shared channel select register, so driver calls for
+   * channels of the same chip are serialized under drv_mtx(), taken
+   * last.  Chips of a multi board set are programmed independently. */
+  boost::shared_mutex& board_mtx() { return _board_mtx; }
+  boost::mutex& chan_mtx(xtrx_direction_t dir, size_t chan);
+  boost::mutex& drv_mtx(size_t chan);
+
 protected:
   xtrx_dev* _obj;
   bool      _run;
@@ -63,6 +107,10 @@ protected:
 
   unsigned  _flags;
   unsigned  _devices;
+
+  boost::shared_mutex _board_mtx;
+  std::unique_ptr<boost::mutex[]> _chan_mtx;
+  std::unique_ptr<boost::mutex[]> _drv_mtx;
 };
 
 #endif // XTRX_OBJ_H
@@ -68,14 +68,14 @@ xtrx_sink_c::xtrx_sink_c(const std::string &args) :
   _sample_flags(0),
   _rate(0),
   _master(0),
-  _freq(0),
+  _freq(parse_nchan(args)),
   _corr(0),
-  _bandwidth(0),
+  _bandwidth(parse_nchan(args)),
   _dsp(0),
   _auto_gain(false),
   _otw(XTRX_WF_16),
   _mimo_mode(false),
-  _gain_tx(0),
+  _gain_tx(parse_nchan(args)),
   _channels(parse_nchan(args)),
   _ts(8192),
   _swap_ab(false),
@@ -201,33 +201,48 @@ osmosdr::freq_range_t xtrx_sink_c::get_freq_range( size_t chan )
 
 double xtrx_sink_c::set_center_freq( double freq, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  std::map< size_t, double > freqs;
+  freqs[chan] = freq;
 
-  _freq = freq;
-  double corr_freq = (freq)*(1.0 + (_corr) * 0.000001);
+  tune_channels(freqs);
 
-  std::cerr << "TX Set freq " << freq << std::endl;
-  xtrx_channel_t xchan = (xtrx_channel_t)(XTRX_CH_A << chan);
+  return get_center_freq(chan);
+}
 
-  int res = xtrx_tune_ex(_xtrx->dev(), (_tdd) ? XTRX_TUNE_TX_AND_RX_TDD : XTRX_TUNE_TX_FDD, xchan, corr_freq - _dsp, &_freq);
-  if (res) {
-    std::cerr << "Unable to deliver frequency " << corr_freq << std::endl;
+void xtrx_sink_c::tune_channels( const std::map< size_t, double > &freqs )
+{
+  xtrx_obj::chan_settings_list batch;
+  for (const std::pair< const size_t, double > &f : freqs) {
+    std::cerr << "TX Set freq " << f.second << std::endl;
+
+    batch.push_back(xtrx_obj::chan_settings_t(XTRX_TX, f.first));
+    batch.back().tune = (_tdd) ? XTRX_TUNE_TX_AND_RX_TDD : XTRX_TUNE_TX_FDD;
+    batch.back().freq = f.second * (1.0 + (_corr) * 0.000001) - _dsp;
+    batch.back().bb_freq = _dsp;
   }
 
-  res = xtrx_tune_ex(_xtrx->dev(), XTRX_TUNE_BB_TX, xchan, _dsp, NULL);
-  return get_center_freq(chan);
+  _xtrx->commit(batch, [&]() {
+    for (const xtrx_obj::chan_settings_t& s : batch)
+      _freq[s.chan] = s.actual_freq;
+  });
 }
 
 double xtrx_sink_c::get_center_freq( size_t chan )
 {
-  return _freq + _dsp;
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_TX, chan));
+  return _freq.at(chan) + _dsp;
 }
 
 double xtrx_sink_c::set_freq_corr( double ppm, size_t chan )
 {
   _corr = ppm;
 
-  set_center_freq(_freq, chan);
+  /* the correction is board wide, retune all channels in one commit */
+  std::map< size_t, double > freqs;
+  for (size_t i = 0; i < _channels; i++)
+    freqs[i] = get_center_freq(i);
+
+  tune_channels(freqs);
 
   return get_freq_corr( chan );
 }
@@ -275,37 +290,32 @@ double xtrx_sink_c::set_gain( double gain, size_t chan )
 
 double xtrx_sink_c::set_gain( double igain, const std::string & name, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
-
   osmosdr::gain_range_t gains = xtrx_sink_c::get_gain_range( name, chan );
   double gain = gains.clip(igain);
-  double actual_gain;
 
   std::cerr << "Set TX gain: " << igain << std::endl;
 
-  int res = xtrx_set_gain(_xtrx->dev(), (xtrx_channel_t)(XTRX_CH_A << chan),
-                          XTRX_TX_PAD_GAIN, gain, &actual_gain);
-  if (res) {
-    std::cerr << "Unable to set gain `" << name.c_str() << "`; err=" << res << std::endl;
-  }
+  xtrx_obj::chan_settings_list batch(1, xtrx_obj::chan_settings_t(XTRX_TX, chan));
+  batch[0].gain = gain;
 
-  _gain_tx = actual_gain;
-  return actual_gain;
+  _xtrx->commit(batch, [&]() { _gain_tx.at(chan) = batch[0].actual_gain; });
+
+  return batch[0].actual_gain;
 }
 
 double xtrx_sink_c::get_gain( size_t chan )
 {
-  return get_gain("TX");
+  return get_gain("TX", chan);
 }
 
 double xtrx_sink_c::get_gain( const std::string & name, size_t chan )
 {
-  return _gain_tx;
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_TX, chan));
+  return _gain_tx.at(chan);
 }
 
 double xtrx_sink_c::set_bandwidth( double bandwidth, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
   std::cerr << "Set bandwidth " << bandwidth << " chan " << chan << std::endl;
 
   if (bandwidth <= 0.0) {
@@ -315,18 +325,18 @@ double xtrx_sink_c::set_bandwidth( double bandwidth, size_t chan )
     }
   }
 
-  int res = xtrx_tune_tx_bandwidth(_xtrx->dev(),
-                                   (xtrx_channel_t)(XTRX_CH_A << chan),
-                                   bandwidth, &_bandwidth);
-  if (res) {
-    std::cerr << "Can't set bandwidth: " << res << std::endl;
-  }
+  xtrx_obj::chan_settings_list batch(1, xtrx_obj::chan_settings_t(XTRX_TX, chan));
+  batch[0].bandwidth = bandwidth;
+
+  _xtrx->commit(batch, [&]() { _bandwidth.at(chan) = batch[0].actual_bandwidth; });
+
   return get_bandwidth(chan);
 }
 
 double xtrx_sink_c::get_bandwidth( size_t chan )
 {
-  return _bandwidth;
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_TX, chan));
+  return _bandwidth.at(chan);
 }
 
 
@@ -367,11 +377,13 @@ std::vector< std::string > xtrx_sink_c::get_antennas( size_t chan )
 
 std::string xtrx_sink_c::set_antenna( const std::string & antenna, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::shared_lock<boost::shared_mutex> board(_xtrx->board_mtx());
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_TX, chan));
   _ant = get_ant_type(antenna);
 
   std::cerr << "Set antenna " << antenna << std::endl;
 
+  boost::mutex::scoped_lock drv(_xtrx->drv_mtx(chan));
   int res = xtrx_set_antenna_ex(_xtrx->dev(),
                                 (xtrx_channel_t)(XTRX_CH_A << chan),
                                 _ant);
@@ -461,7 +473,7 @@ int xtrx_sink_c::work (int noutput_items,
 
 bool xtrx_sink_c::start()
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::unique_lock<boost::shared_mutex> lock(_xtrx->board_mtx());
 
   xtrx_run_params_t params;
   xtrx_run_params_init(&params);
@@ -492,7 +504,7 @@ bool xtrx_sink_c::start()
 
 bool xtrx_sink_c::stop()
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::unique_lock<boost::shared_mutex> lock(_xtrx->board_mtx());
 
   //TODO:
   std::cerr << "xtrx_sink_c::stop()" << std::endl;
@@ -95,22 +95,24 @@ public:
   void tag_process(int ninput_items);
 
 private:
+  void tune_channels( const std::map< size_t, double > &freqs );
+
   xtrx_obj_sptr _xtrx;
   std::vector<gr::tag_t> _tags;
 
   unsigned _sample_flags;
   double _rate;
   double _master;
-  double _freq;
+  std::vector< double > _freq;
   double _corr;
-  double _bandwidth;
+  std::vector< double > _bandwidth;
   double _dsp;
   bool _auto_gain;
 
   xtrx_wire_format_t _otw;
   bool _mimo_mode;
 
-  int _gain_tx;
+  std::vector< int > _gain_tx;
 
   unsigned _channels;
   xtrx_antenna_t _ant;
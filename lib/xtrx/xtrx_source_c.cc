@@ -68,15 +68,15 @@ xtrx_source_c::xtrx_source_c(const std::string &args) :
   _sample_flags(0),
   _rate(0),
   _master(0),
-  _freq(0),
+  _freq(parse_nchan(args)),
   _corr(0),
-  _bandwidth(0),
+  _bandwidth(parse_nchan(args)),
   _auto_gain(false),
   _otw(XTRX_WF_16),
   _mimo_mode(false),
-  _gain_lna(0),
-  _gain_tia(0),
-  _gain_pga(0),
+  _gain_lna(parse_nchan(args)),
+  _gain_tia(parse_nchan(args)),
+  _gain_pga(parse_nchan(args)),
   _channels(parse_nchan(args)),
   _swap_ab(false),
   _swap_iq(false),
@@ -248,38 +248,50 @@ osmosdr::freq_range_t xtrx_source_c::get_freq_range( size_t chan )
 
 double xtrx_source_c::set_center_freq( double freq, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  std::map< size_t, double > freqs;
+  freqs[chan] = freq;
 
-  _freq = freq;
-  double corr_freq = (freq)*(1.0 + (_corr) * 0.000001);
+  tune_channels(freqs);
 
-  if (_tdd)
-    return get_center_freq(chan);
-
-  xtrx_channel_t xchan = (xtrx_channel_t)(XTRX_CH_A << chan);
+  return get_center_freq(chan);
+}
 
-  std::cerr << "Set freq " << freq << std::endl;
+void xtrx_source_c::tune_channels( const std::map< size_t, double > &freqs )
+{
+  xtrx_obj::chan_settings_list batch;
+  for (const std::pair< const size_t, double > &f : freqs) {
+    std::cerr << "Set freq " << f.second << std::endl;
 
-  int res = xtrx_tune_ex(_xtrx->dev(), XTRX_TUNE_RX_FDD, xchan, corr_freq - _dsp, &_freq);
-  if (res) {
-    std::cerr << "Unable to deliver frequency " << corr_freq << std::endl;
+    batch.push_back(xtrx_obj::chan_settings_t(XTRX_RX, f.first));
+    /* with TDD the sink tunes the shared LO, only remember the request */
+    if (!_tdd) {
+      batch.back().freq = f.second * (1.0 + (_corr) * 0.000001) - _dsp;
+      batch.back().bb_freq = _dsp;
+    }
   }
 
-  res = xtrx_tune_ex(_xtrx->dev(), XTRX_TUNE_BB_RX, xchan, _dsp, NULL);
-
-  return get_center_freq(chan);
+  _xtrx->commit(batch, [&]() {
+    for (const xtrx_obj::chan_settings_t& s : batch)
+      _freq[s.chan] = _tdd ? freqs.at(s.chan) : s.actual_freq;
+  });
 }
 
 double xtrx_source_c::get_center_freq( size_t chan )
 {
-  return _freq;
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_RX, chan));
+  return _freq.at(chan);
 }
 
 double xtrx_source_c::set_freq_corr( double ppm, size_t chan )
 {
   _corr = ppm;
 
-  set_center_freq(_freq, chan);
+  /* the correction is board wide, retune all channels in one commit */
+  std::map< size_t, double > freqs;
+  for (size_t i = 0; i < _channels; i++)
+    freqs[i] = get_center_freq(i);
+
+  tune_channels(freqs);
 
   return get_freq_corr( chan );
 }
@@ -360,43 +372,41 @@ double xtrx_source_c::set_gain( double gain, size_t chan )
 
 double xtrx_source_c::set_gain( double igain, const std::string & name, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
-
   osmosdr::gain_range_t gains = xtrx_source_c::get_gain_range( name, chan );
   double gain = gains.clip(igain);
-  double actual_gain;
   xtrx_gain_type_t gt = get_gain_type(name);
 
   std::cerr << "Set gain " << name << " (" << gt << "): " << igain << std::endl;
 
-  int res = xtrx_set_gain(_xtrx->dev(), (xtrx_channel_t)(XTRX_CH_A << chan),
-                          gt, gain, &actual_gain);
-  if (res) {
-    std::cerr << "Unable to set gain `" << name.c_str() << "`; err=" << res << std::endl;
-  }
+  xtrx_obj::chan_settings_list batch(1, xtrx_obj::chan_settings_t(XTRX_RX, chan));
+  batch[0].gain_type = gt;
+  batch[0].gain = gain;
 
-  switch (gt) {
-  case XTRX_RX_LNA_GAIN: _gain_lna = actual_gain; break;
-  case XTRX_RX_TIA_GAIN: _gain_tia = actual_gain; break;
-  case XTRX_RX_PGA_GAIN: _gain_pga = actual_gain; break;
-  default: break;
-  }
+  _xtrx->commit(batch, [&]() {
+    switch (gt) {
+    case XTRX_RX_LNA_GAIN: _gain_lna.at(chan) = batch[0].actual_gain; break;
+    case XTRX_RX_TIA_GAIN: _gain_tia.at(chan) = batch[0].actual_gain; break;
+    case XTRX_RX_PGA_GAIN: _gain_pga.at(chan) = batch[0].actual_gain; break;
+    default: break;
+    }
+  });
 
-  return actual_gain;
+  return batch[0].actual_gain;
 }
 
 double xtrx_source_c::get_gain( size_t chan )
 {
-  return get_gain("LNA");
+  return get_gain("LNA", chan);
 }
 
 double xtrx_source_c::get_gain( const std::string & name, size_t chan )
 {
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_RX, chan));
   xtrx_gain_type_t gt = get_gain_type(name);
   switch (gt) {
-  case XTRX_RX_LNA_GAIN: return _gain_lna;
-  case XTRX_RX_TIA_GAIN: return _gain_tia;
-  case XTRX_RX_PGA_GAIN: return _gain_pga;
+  case XTRX_RX_LNA_GAIN: return _gain_lna.at(chan);
+  case XTRX_RX_TIA_GAIN: return _gain_tia.at(chan);
+  case XTRX_RX_PGA_GAIN: return _gain_pga.at(chan);
   default: return 0;
   }
 }
@@ -408,7 +418,6 @@ double xtrx_source_c::set_if_gain(double gain, size_t chan)
 
 double xtrx_source_c::set_bandwidth( double bandwidth, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
   std::cerr << "Set bandwidth " << bandwidth << " chan " << chan << std::endl;
 
   if (bandwidth <= 0.0) {
@@ -418,17 +427,18 @@ double xtrx_source_c::set_bandwidth( double bandwidth, size_t chan )
     }
   }
 
-  int res = xtrx_tune_rx_bandwidth(_xtrx->dev(), (xtrx_channel_t)(XTRX_CH_A << chan),
-                                   bandwidth, &_bandwidth);
-  if (res) {
-    std::cerr << "Can't set bandwidth: " << res << std::endl;
-  }
+  xtrx_obj::chan_settings_list batch(1, xtrx_obj::chan_settings_t(XTRX_RX, chan));
+  batch[0].bandwidth = bandwidth;
+
+  _xtrx->commit(batch, [&]() { _bandwidth.at(chan) = batch[0].actual_bandwidth; });
+
   return get_bandwidth(chan);
 }
 
 double xtrx_source_c::get_bandwidth( size_t chan )
 {
-  return _bandwidth;
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_RX, chan));
+  return _bandwidth.at(chan);
 }
 
 osmosdr::freq_range_t xtrx_source_c::get_bandwidth_range( size_t chan )
@@ -478,11 +488,13 @@ std::vector< std::string > xtrx_source_c::get_antennas( size_t chan )
 
 std::string xtrx_source_c::set_antenna( const std::string & antenna, size_t chan )
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::shared_lock<boost::shared_mutex> board(_xtrx->board_mtx());
+  boost::mutex::scoped_lock lock(_xtrx->chan_mtx(XTRX_RX, chan));
   _ant = get_ant_type(antenna);
 
   std::cerr << "Set antenna " << antenna << " type:" << _ant << std::endl;
 
+  boost::mutex::scoped_lock drv(_xtrx->drv_mtx(chan));
   int res = xtrx_set_antenna_ex(_xtrx->dev(), (xtrx_channel_t)(XTRX_CH_A << chan),
                                 _ant);
   if (res) {
@@ -536,7 +548,7 @@ int xtrx_source_c::work (int noutput_items,
 
 bool xtrx_source_c::start()
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::unique_lock<boost::shared_mutex> lock(_xtrx->board_mtx());
 
   xtrx_run_params_t params;
   xtrx_run_params_init(&params);
@@ -571,7 +583,7 @@ bool xtrx_source_c::start()
 
 bool xtrx_source_c::stop()
 {
-  boost::mutex::scoped_lock lock(_xtrx->mtx);
+  boost::unique_lock<boost::shared_mutex> lock(_xtrx->board_mtx());
   //TODO:
   std::cerr << "xtrx_source_c::stop()" << std::endl;
   int res = xtrx_stop(_xtrx->dev(), XTRX_RX);
@@ -92,23 +92,25 @@ public:
   bool stop();
 
 private:
+  void tune_channels( const std::map< size_t, double > &freqs );
+
   xtrx_obj_sptr _xtrx;
   pmt::pmt_t _id;
 
   unsigned _sample_flags;
   double _rate;
   double _master;
-  double _freq;
+  std::vector< double > _freq;
   double _corr;
-  double _bandwidth;
+  std::vector< double > _bandwidth;
   bool _auto_gain;
 
   xtrx_wire_format_t _otw;
   bool _mimo_mode;
 
-  int _gain_lna;
-  int _gain_tia;
-  int _gain_pga;
+  std::vector< int > _gain_lna;
+  std::vector< int > _gain_tia;
+  std::vector< int > _gain_pga;
 
   unsigned _channels;
   xtrx_antenna_t _ant;
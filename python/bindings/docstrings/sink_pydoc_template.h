@@ -150,4 +150,10 @@
 
  static const char *__doc_osmosdr_sink_set_time_unknown_pps = R"doc()doc";
 
+
+ static const char *__doc_osmosdr_sink_set_command_time = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_sink_clear_command_time = R"doc()doc";
+
   
@@ -109,7 +109,18 @@
  static const char *__doc_osmosdr_source_set_iq_balance_mode = R"doc()doc";
 
 
- static const char *__doc_osmosdr_source_set_iq_balance = R"doc()doc";
+ static const char *__doc_osmosdr_source_set_iq_balance = R"doc(Set the RX frontend IQ balance correction.
+
+Devices correcting the balance in hardware take their native correction
+value. For the others the balance is corrected in software, by a
+built-in corrector or, with the iqbal=gr device argument, by
+gr-iqbalance. Both take the relative gain error between I and Q as the real
+part, 0 being balanced, and the phase error in radians as the imaginary
+part.
+
+Args:
+    balance: the complex correction value
+    chan: the channel index 0 to N-1)doc";
 
 
  static const char *__doc_osmosdr_source_set_bandwidth = R"doc()doc";
@@ -159,4 +170,16 @@
 
  static const char *__doc_osmosdr_source_set_time_unknown_pps = R"doc()doc";
 
+
+ static const char *__doc_osmosdr_source_set_command_time = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_clear_command_time = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_seek_time = R"doc()doc";
+
+
+ static const char *__doc_osmosdr_source_seek_segment = R"doc()doc";
+
   
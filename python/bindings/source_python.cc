@@ -14,7 +14,7 @@
 /* BINDTOOL_GEN_AUTOMATIC(1)                                                       */
 /* BINDTOOL_USE_PYGCCXML(0)                                                        */
 /* BINDTOOL_HEADER_FILE(source.h)                                        */
-/* BINDTOOL_HEADER_FILE_HASH(d1a3d9ea3d815fe4f18acc3eef21f1b6)                     */
+/* BINDTOOL_HEADER_FILE_HASH(8d76e0010a9fcf837220c3179ff6a0c6)                     */
 /***********************************************************************************/
 
 #include <pybind11/complex.h>
@@ -327,6 +327,33 @@ void bind_source(py::module& m)
             D(source,set_time_unknown_pps)
         )
 
+
+        .def("set_command_time",&source::set_command_time,
+            py::arg("time_spec"),
+            py::arg("mboard") = 0,
+            D(source,set_command_time)
+        )
+
+
+        .def("clear_command_time",&source::clear_command_time,
+            py::arg("mboard") = 0,
+            D(source,clear_command_time)
+        )
+
+
+        .def("seek_time",&source::seek_time,
+            py::arg("time"),
+            py::arg("chan") = 0,
+            D(source,seek_time)
+        )
+
+
+        .def("seek_segment",&source::seek_segment,
+            py::arg("segment"),
+            py::arg("chan") = 0,
+            D(source,seek_segment)
+        )
+
         ;
 
 